@@ -242,6 +242,37 @@ namespace graphene { namespace app {
        return _app.p2p_node()->set_advanced_node_parameters(params);
     }
 
+    fc::variant_object network_node_api::get_block_phase_stats() const
+    {
+       const auto& stats = _app.chain_database()->get_block_phase_stats();
+       fc::mutable_variant_object result;
+       for( size_t i = 0; i < chain::block_phase_count; ++i )
+          result[ fc::reflector<chain::block_phase>::to_string( chain::block_phase( i ) ) ] = fc::variant( stats[i], 2 );
+       return result;
+    }
+
+    signature_key_cache_stats network_node_api::get_signature_cache_stats() const
+    {
+       return signature_key_cache::instance().get_stats();
+    }
+
+    packed_size_stats network_node_api::get_packed_size_stats() const
+    {
+       return graphene::protocol::get_packed_size_stats();
+    }
+
+    fc::variant_object network_node_api::get_operation_timing_stats() const
+    {
+       const auto& stats = _app.chain_database()->get_operation_timing_stats();
+       fc::mutable_variant_object result;
+       for( size_t i = 0; i < stats.size(); ++i )
+       {
+          if( stats[i].evaluate.count > 0 )
+             result[ chain::operation_type_name( i ) ] = fc::variant( stats[i], 3 );
+       }
+       return result;
+    }
+
     fc::api<network_broadcast_api> login_api::network_broadcast()const
     {
        FC_ASSERT(_network_broadcast_api);
@@ -683,71 +714,110 @@ namespace graphene { namespace app {
           _app(app),
           _db( *app.chain_database()),
           database_api( std::ref(*app.chain_database()), &(app.get_options())
-          ) { }
+          )
+    {
+       if( app.get_options().has_api_helper_indexes_plugin )
+          _holders_count_index = &_db.get_index_type< primary_index< account_balance_index > >()
+                .get_secondary_index< graphene::api_helper_indexes::asset_holders_count_index >();
+    }
     asset_api::~asset_api() { }
 
     vector<account_asset_balance> asset_api::get_asset_holders( std::string asset, uint32_t start, uint32_t limit ) const {
        uint64_t api_limit_get_asset_holders=_app.get_options().api_limit_get_asset_holders;
        FC_ASSERT(limit <= api_limit_get_asset_holders);
        asset_id_type asset_id = database_api.get_asset_id_from_string( asset );
-       const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
-       auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
+       const auto& balances = get_asset_balances( asset_id );
 
        vector<account_asset_balance> result;
 
        uint32_t index = 0;
-       for( const account_balance_object& bal : boost::make_iterator_range( range.first, range.second ) )
+       for( const auto& bal : balances )
        {
           if( result.size() >= limit )
              break;
 
-          if( bal.balance.value == 0 )
-             continue;
-
           if( index++ < start )
              continue;
 
-          const auto account = _db.find(bal.owner);
+          const auto account = _db.find(bal.first.second);
 
           account_asset_balance aab;
           aab.name       = account->name;
           aab.account_id = account->id;
-          aab.amount     = bal.balance.value;
+          aab.amount     = bal.first.first.value;
 
           result.push_back(aab);
        }
 
        return result;
     }
-    // get number of asset holders.
-    int asset_api::get_asset_holders_count( std::string asset ) const {
-       const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
+
+    vector<account_asset_balance> asset_api::get_asset_holders_after( std::string asset,
+                                                                      optional<share_type> start_amount,
+                                                                      optional<account_id_type> start_account,
+                                                                      uint32_t limit ) const {
+       uint64_t api_limit_get_asset_holders=_app.get_options().api_limit_get_asset_holders;
+       FC_ASSERT(limit <= api_limit_get_asset_holders);
        asset_id_type asset_id = database_api.get_asset_id_from_string( asset );
-       auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
+       const auto& balances = get_asset_balances( asset_id );
 
-       int count = boost::distance(range) - 1;
+       auto itr = balances.begin();
+       if( start_amount.valid() && start_account.valid() )
+          itr = balances.upper_bound( std::make_pair( *start_amount, *start_account ) );
+       else if( start_amount.valid() )
+          itr = balances.lower_bound( std::make_pair( *start_amount, account_id_type() ) );
 
+       vector<account_asset_balance> result;
+       result.reserve( limit );
+       for( ; itr != balances.end() && result.size() < limit; ++itr )
+       {
+          const account_object& account = itr->first.second(_db);
+
+          account_asset_balance aab;
+          aab.name       = account.name;
+          aab.account_id = account.id;
+          aab.amount     = itr->first.first.value;
+
+          result.push_back(aab);
+       }
+
+       return result;
+    }
+
+    const balances_by_asset_index::asset_balances& asset_api::get_asset_balances( asset_id_type asset_id ) const {
+       return _db.get_index_type< primary_index< account_balance_index > >()
+                 .get_secondary_index< balances_by_asset_index >().get_asset_balances( _db, asset_id );
+    }
+
+    uint64_t asset_api::count_asset_holders( asset_id_type asset_id ) const {
+       if( _holders_count_index )
+          return _holders_count_index->get_holders_count( asset_id );
+
+       // count without sorting the balances of every asset
+       const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_owner >();
+       auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
+       uint64_t count = 0;
+       for( const account_balance_object& bal : boost::make_iterator_range( range.first, range.second ) )
+       {
+          if( bal.balance.value != 0 )
+             ++count;
+       }
        return count;
     }
+
+    // get number of asset holders.
+    int asset_api::get_asset_holders_count( std::string asset ) const {
+       asset_id_type asset_id = database_api.get_asset_id_from_string( asset );
+       return static_cast<int>( count_asset_holders( asset_id ) );
+    }
     // function to get vector of system assets with holders count.
     vector<asset_holders> asset_api::get_all_asset_holders() const {
        vector<asset_holders> result;
-       vector<asset_id_type> total_assets;
        for( const asset_object& asset_obj : _db.get_index_type<asset_index>().indices() )
        {
-          const auto& dasset_obj = asset_obj.dynamic_asset_data_id(_db);
-
-          asset_id_type asset_id;
-          asset_id = dasset_obj.id;
-
-          const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
-          auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
-
-          int count = boost::distance(range) - 1;
-
           asset_holders ah;
-          ah.asset_id       = asset_id;
-          ah.count     = count;
+          ah.asset_id       = asset_obj.get_id();
+          ah.count     = static_cast<int>( count_asset_holders( ah.asset_id ) );
 
           result.push_back(ah);
        }
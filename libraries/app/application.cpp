@@ -29,6 +29,7 @@
 #include <graphene/chain/db_with.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 #include <graphene/protocol/types.hpp>
 
 #include <graphene/egenesis/egenesis.hpp>
@@ -464,7 +465,8 @@ void application_impl::startup()
       {
          std::string genesis_str;
          fc::read_file_contents( _options->at("genesis-json").as<boost::filesystem::path>(), genesis_str );
-         graphene::chain::genesis_state_type genesis = fc::json::from_string( genesis_str ).as<graphene::chain::genesis_state_type>( 20 );
+         graphene::chain::genesis_state_type genesis
+               = graphene::chain::load_genesis_state( fc::json::from_string( genesis_str ), 20 );
          bool modified_genesis = false;
          if( _options->count("genesis-timestamp") )
          {
@@ -504,7 +506,7 @@ void application_impl::startup()
          graphene::egenesis::compute_egenesis_json( egenesis_json );
          FC_ASSERT( egenesis_json != "" );
          FC_ASSERT( graphene::egenesis::get_egenesis_json_hash() == fc::sha256::hash( egenesis_json ) );
-         auto genesis = fc::json::from_string( egenesis_json ).as<graphene::chain::genesis_state_type>( 20 );
+         auto genesis = graphene::chain::load_genesis_state( fc::json::from_string( egenesis_json ), 20 );
          genesis.initial_chain_id = fc::sha256::hash( egenesis_json );
          return genesis;
       }
@@ -531,6 +533,21 @@ void application_impl::startup()
       _chain_db->enable_standby_votes_tracking( _options->at("enable-standby-votes-tracking").as<bool>() );
    }
 
+   if( _options->count("signature-cache-size") )
+   {
+      graphene::protocol::signature_key_cache::instance().set_capacity(
+            _options->at("signature-cache-size").as<uint32_t>() );
+   }
+
+   if( _options->count("slow-block-trace-threshold-ms") )
+   {
+      _chain_db->set_slow_block_threshold(
+            fc::milliseconds( _options->at("slow-block-trace-threshold-ms").as<uint32_t>() ) );
+   }
+
+   if( _options->count("enable-operation-timing") )
+      _chain_db->set_operation_timing_enabled( _options->at("enable-operation-timing").as<bool>() );
+
    if( _options->count("replay-blockchain") || _options->count("revalidate-blockchain") )
       _chain_db->wipe( _data_dir / "blockchain", false );
 
@@ -834,7 +851,9 @@ message application_impl::get_item(const item_id& id)
       // ilog("Serving up block #${num}", ("num", opt_block->block_num()));
       return block_message(std::move(*opt_block));
    }
-   return trx_message( _chain_db->get_recent_transaction( id.item_hash ) );
+   auto opt_trx = _chain_db->get_recent_transaction( id.item_hash );
+   FC_ASSERT( opt_trx.valid() );
+   return trx_message( std::move(*opt_trx) );
 } FC_CAPTURE_AND_RETHROW( (id) ) }
 
 chain_id_type application_impl::get_chain_id() const
@@ -1128,6 +1147,16 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("enable-standby-votes-tracking", bpo::value<bool>()->implicit_value(true),
           "Whether to enable tracking of votes of standby witnesses and committee members. "
           "Set it to true to provide accurate data to API clients, set to false for slightly better performance.")
+         ("signature-cache-size", bpo::value<uint32_t>()->default_value(
+               graphene::protocol::signature_key_cache::default_capacity ),
+          "Number of public keys recovered from transaction signatures to keep, so that a transaction received "
+          "alone and then in a block is only recovered once, 0 to disable")
+         ("slow-block-trace-threshold-ms", bpo::value<uint32_t>()->default_value(0),
+          "Log the time spent in every step of a block whose push or application takes longer than this many "
+          "milliseconds, 0 to disable")
+         ("enable-operation-timing", bpo::value<bool>()->implicit_value(true),
+          "Whether to measure the evaluation of every type of operation. The measures are logged at every "
+          "maintenance interval and available through the network_node API.")
          ("api-limit-get-account-history-operations",boost::program_options::value<uint64_t>()->default_value(100),
           "For history_api::get_account_history_operations to set max limit value")
          ("api-limit-get-account-history",boost::program_options::value<uint64_t>()->default_value(100),
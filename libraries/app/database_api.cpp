@@ -27,6 +27,8 @@
 #include <graphene/app/util.hpp>
 #include <graphene/chain/get_config.hpp>
 #include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/liquidity_pool_evaluator.hpp>
+#include <graphene/chain/order_book_index.hpp>
 #include <graphene/protocol/pts_address.hpp>
 
 #include <fc/crypto/hex.hpp>
@@ -57,16 +59,16 @@ database_api_impl::database_api_impl( graphene::chain::database& db, const appli
 {
    dlog("creating database api ${x}", ("x",int64_t(this)) );
    _new_connection = _db.new_objects.connect([this](const vector<object_id_type>& ids,
-                                                    const flat_set<account_id_type>& impacted_accounts) {
+                                                    const impacted_accounts_cache& impacted_accounts) {
                                 on_objects_new(ids, impacted_accounts);
                                 });
    _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids,
-                                                           const flat_set<account_id_type>& impacted_accounts) {
+                                                           const impacted_accounts_cache& impacted_accounts) {
                                 on_objects_changed(ids, impacted_accounts);
                                 });
    _removed_connection = _db.removed_objects.connect([this](const vector<object_id_type>& ids,
                                                             const vector<const object*>& objs,
-                                                            const flat_set<account_id_type>& impacted_accounts) {
+                                                            const impacted_accounts_cache& impacted_accounts) {
                                 on_objects_removed(ids, objs, impacted_accounts);
                                 });
    _applied_block_connection = _db.applied_block.connect([this](const signed_block&){ on_applied_block(); });
@@ -258,11 +260,7 @@ processed_transaction database_api::get_transaction( uint32_t block_num, uint32_
 
 optional<signed_transaction> database_api::get_recent_transaction_by_id( const transaction_id_type& id )const
 {
-   try {
-      return my->_db.get_recent_transaction( id );
-   } catch ( ... ) {
-      return optional<signed_transaction>();
-   }
+   return my->_db.get_recent_transaction( id );
 }
 
 processed_transaction database_api_impl::get_transaction(uint32_t block_num, uint32_t trx_num)const
@@ -1590,6 +1588,52 @@ order_book database_api_impl::get_order_book( const string& base, const string&
    return result;
 }
 
+aggregated_order_book database_api::get_aggregated_order_book( const string& base, const string& quote,
+                                                              unsigned limit )const
+{
+   return my->get_aggregated_order_book( base, quote, limit );
+}
+
+aggregated_order_book database_api_impl::get_aggregated_order_book( const string& base, const string& quote,
+                                                                   unsigned limit )const
+{
+   FC_ASSERT( limit <= _app_options->api_limit_get_order_book );
+
+   aggregated_order_book result;
+   result.base = base;
+   result.quote = quote;
+
+   auto assets = lookup_asset_symbols( {base, quote} );
+   FC_ASSERT( assets[0], "Invalid base asset symbol: ${s}", ("s",base) );
+   FC_ASSERT( assets[1], "Invalid quote asset symbol: ${s}", ("s",quote) );
+
+   const auto& idx = _db.get_index_type<limit_order_index>();
+   const auto& book = dynamic_cast<const base_primary_index&>( idx ).get_secondary_index<order_book_index>();
+
+   // Bids sell the base asset, asks sell the quote asset
+   for( bool bids : { true, false } )
+   {
+      const auto& sell_asset = bids ? *assets[0] : *assets[1];
+      const auto& receive_asset = bids ? *assets[1] : *assets[0];
+      auto& levels = bids ? result.bids : result.asks;
+      auto range = book.get_levels( sell_asset.id, receive_asset.id );
+      for( auto itr = range.first; itr != range.second && levels.size() < limit; ++itr )
+      {
+         const price& level_price = itr->first;
+         const share_type received( fc::uint128_t( itr->second.for_sale.value ) * level_price.quote.amount.value
+                                    / level_price.base.amount.value );
+         order_book_level level;
+         level.price = price_to_string( level_price, *assets[0], *assets[1] );
+         level.base = assets[0]->amount_to_string( bids ? itr->second.for_sale : received );
+         level.quote = assets[1]->amount_to_string( bids ? received : itr->second.for_sale );
+         level.orders = itr->second.orders.size();
+         levels.push_back( level );
+      }
+   }
+
+   return result;
+}
+
 vector<market_ticker> database_api::get_top_markets(uint32_t limit)const
 {
    return my->get_top_markets(limit);
@@ -2169,6 +2213,108 @@ vector<extended_liquidity_pool_object> database_api_impl::get_liquidity_pools_by
    return results;
 }
 
+optional<liquidity_pool_route> database_api::get_liquidity_pool_route(
+            std::string asset_symbol_or_id_to_sell,
+            share_type amount_to_sell,
+            std::string asset_symbol_or_id_to_receive,
+            optional<uint8_t> max_pools )const
+{
+   return my->get_liquidity_pool_route(
+            asset_symbol_or_id_to_sell,
+            amount_to_sell,
+            asset_symbol_or_id_to_receive,
+            max_pools );
+}
+
+optional<liquidity_pool_route> database_api_impl::get_liquidity_pool_route(
+            std::string asset_symbol_or_id_to_sell,
+            share_type amount_to_sell,
+            std::string asset_symbol_or_id_to_receive,
+            optional<uint8_t> omax_pools )const
+{
+   uint8_t max_pools = omax_pools.valid() ? *omax_pools : 3;
+   FC_ASSERT( max_pools > 0 && max_pools <= GRAPHENE_MAX_LIQUIDITY_POOL_ROUTE_LENGTH,
+              "max_pools should be between 1 and ${n}", ("n", GRAPHENE_MAX_LIQUIDITY_POOL_ROUTE_LENGTH) );
+   FC_ASSERT( amount_to_sell > 0, "Amount to sell should be positive" );
+
+   const asset_id_type sell_asset_id = get_asset_from_string( asset_symbol_or_id_to_sell )->id;
+   const asset_id_type receive_asset_id = get_asset_from_string( asset_symbol_or_id_to_receive )->id;
+   FC_ASSERT( sell_asset_id != receive_asset_id, "The two assets should not be the same" );
+
+   const auto& by_a = _db.get_index_type<liquidity_pool_index>().indices().get<by_asset_ab>();
+   const auto& by_b = _db.get_index_type<liquidity_pool_index>().indices().get<by_asset_b>();
+
+   // The best route found so far to every asset reached with the same number of pools
+   flat_map<asset_id_type, liquidity_pool_route> reached;
+   reached[ sell_asset_id ] = liquidity_pool_route{ {}, asset( amount_to_sell, sell_asset_id ),
+                                                    asset( amount_to_sell, sell_asset_id ) };
+   optional<liquidity_pool_route> best;
+
+   for( uint8_t hops = 1; hops <= max_pools && !reached.empty(); ++hops )
+   {
+      flat_map<asset_id_type, liquidity_pool_route> next;
+      for( const auto& item : reached )
+      {
+         const liquidity_pool_route& route = item.second;
+         const asset_object& sell_asset = item.first(_db);
+
+         auto try_pool = [&]( const liquidity_pool_object& pool ) {
+            const liquidity_pool_id_type pool_id = pool.id;
+            if( pool.balance_a == 0 || pool.balance_b == 0 )
+               return;
+            if( std::find( route.pools.begin(), route.pools.end(), pool_id ) != route.pools.end() )
+               return;
+            const asset_id_type other_id = ( pool.asset_a == item.first ? pool.asset_b : pool.asset_a );
+            if( other_id == sell_asset_id )
+               return;
+            const bool is_last = ( other_id == receive_asset_id );
+            if( !is_last && hops == max_pools )
+               return;
+
+            asset receives;
+            try {
+               receives = calculate_liquidity_pool_exchange( _db, pool, sell_asset, other_id(_db),
+                                                             route.amount_to_receive ).account_receives;
+            } catch( const fc::exception& ) {
+               return; // the pool can not take the amount
+            }
+            if( receives.amount <= 0 )
+               return;
+
+            liquidity_pool_route* target = nullptr;
+            if( is_last )
+            {
+               if( best.valid() && best->amount_to_receive.amount >= receives.amount )
+                  return;
+               best = liquidity_pool_route();
+               target = &(*best);
+            }
+            else
+            {
+               auto itr = next.find( other_id );
+               if( itr != next.end() && itr->second.amount_to_receive.amount >= receives.amount )
+                  return;
+               target = &next[ other_id ];
+            }
+            target->pools = route.pools;
+            target->pools.push_back( pool_id );
+            target->amount_to_sell = route.amount_to_sell;
+            target->amount_to_receive = receives;
+         };
+
+         for( auto itr = by_a.lower_bound( std::make_tuple( item.first ) );
+              itr != by_a.end() && itr->asset_a == item.first; ++itr )
+            try_pool( *itr );
+         for( auto itr = by_b.lower_bound( std::make_tuple( item.first ) );
+              itr != by_b.end() && itr->asset_b == item.first; ++itr )
+            try_pool( *itr );
+      }
+      reached = std::move( next );
+   }
+
+   return best;
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Witnesses                                                        //
@@ -2581,12 +2727,7 @@ bool database_api::verify_authority( const signed_transaction& trx )const
 
 bool database_api_impl::verify_authority( const signed_transaction& trx )const
 {
-   bool allow_non_immediate_owner = ( _db.head_block_time() >= HARDFORK_CORE_584_TIME );
-   trx.verify_authority( _db.get_chain_id(),
-                         [this]( account_id_type id ){ return &id(_db).active; },
-                         [this]( account_id_type id ){ return &id(_db).owner; },
-                         allow_non_immediate_owner,
-                         _db.get_global_properties().parameters.max_authority_depth );
+   _db.verify_transaction_authority( trx );
    return true;
 }
 
@@ -3032,11 +3173,13 @@ vector<limit_order_object> database_api_impl::get_limit_orders( const asset_id_t
    return result;
 }
 
-bool database_api_impl::is_impacted_account( const flat_set<account_id_type>& accounts)
+bool database_api_impl::is_impacted_account( const impacted_accounts_cache& impacted_accounts )
 {
-   if( !_subscribed_accounts.size() || !accounts.size() )
+   // The accounts are only computed when this session subscribed to some
+   if( !_subscribed_accounts.size() )
       return false;
 
+   const auto& accounts = impacted_accounts.get();
    return std::any_of(accounts.begin(), accounts.end(), [this](const account_id_type& account) {
       return _subscribed_accounts.find(account) != _subscribed_accounts.end();
    });
@@ -3071,7 +3214,7 @@ void database_api_impl::broadcast_market_updates( const market_queue_type& queue
 
 void database_api_impl::on_objects_removed( const vector<object_id_type>& ids,
                                             const vector<const object*>& objs,
-                                            const flat_set<account_id_type>& impacted_accounts )
+                                            const impacted_accounts_cache& impacted_accounts )
 {
    handle_object_changed(_notify_remove_create, false, ids, impacted_accounts,
       [objs](object_id_type id) -> const object* {
@@ -3088,7 +3231,7 @@ void database_api_impl::on_objects_removed( const vector<object_id_type>& ids,
 }
 
 void database_api_impl::on_objects_new( const vector<object_id_type>& ids,
-                                        const flat_set<account_id_type>& impacted_accounts )
+                                        const impacted_accounts_cache& impacted_accounts )
 {
    handle_object_changed(_notify_remove_create, true, ids, impacted_accounts,
       std::bind(&object_database::find_object, &_db, std::placeholders::_1)
@@ -3096,7 +3239,7 @@ void database_api_impl::on_objects_new( const vector<object_id_type>& ids,
 }
 
 void database_api_impl::on_objects_changed( const vector<object_id_type>& ids,
-                                            const flat_set<account_id_type>& impacted_accounts )
+                                            const impacted_accounts_cache& impacted_accounts )
 {
    handle_object_changed(false, true, ids, impacted_accounts,
       std::bind(&object_database::find_object, &_db, std::placeholders::_1)
@@ -3106,7 +3249,7 @@ void database_api_impl::on_objects_changed( const vector<object_id_type>& ids,
 void database_api_impl::handle_object_changed( bool force_notify,
                                                bool full_object,
                                                const vector<object_id_type>& ids,
-                                               const flat_set<account_id_type>& impacted_accounts,
+                                               const impacted_accounts_cache& impacted_accounts,
                                                std::function<const object*(object_id_type id)> find_object )
 {
    if( _subscribe_callback )
@@ -130,6 +130,8 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       market_volume                      get_24_volume( const string& base, const string& quote )const;
       order_book                         get_order_book( const string& base, const string& quote,
                                                          unsigned limit = 50 )const;
+      aggregated_order_book              get_aggregated_order_book( const string& base, const string& quote,
+                                                                    unsigned limit = 50 )const;
       vector<market_ticker>              get_top_markets( uint32_t limit )const;
       vector<market_trade>               get_trade_history( const string& base, const string& quote,
                                                             fc::time_point_sec start, fc::time_point_sec stop,
@@ -177,6 +179,11 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
             optional<uint32_t> limit = 101,
             optional<asset_id_type> start_id = optional<asset_id_type>(),
             optional<bool> with_statistics = false )const;
+      optional<liquidity_pool_route> get_liquidity_pool_route(
+            std::string asset_symbol_or_id_to_sell,
+            share_type amount_to_sell,
+            std::string asset_symbol_or_id_to_receive,
+            optional<uint8_t> max_pools = 3 )const;
 
       // Witnesses
       vector<optional<witness_object>> get_witnesses(const vector<witness_id_type>& witness_ids)const;
@@ -416,7 +423,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       }
 
       // for full-account subscription
-      bool is_impacted_account( const flat_set<account_id_type>& accounts );
+      bool is_impacted_account( const impacted_accounts_cache& accounts );
 
       // for market subscription
       template<typename T>
@@ -454,14 +461,14 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       void handle_object_changed( bool force_notify,
                                   bool full_object,
                                   const vector<object_id_type>& ids,
-                                  const flat_set<account_id_type>& impacted_accounts,
+                                  const impacted_accounts_cache& impacted_accounts,
                                   std::function<const object*(object_id_type id)> find_object );
 
       /** called every time a block is applied to report the objects that were changed */
-      void on_objects_new(const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts);
-      void on_objects_changed(const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts);
+      void on_objects_new(const vector<object_id_type>& ids, const impacted_accounts_cache& impacted_accounts);
+      void on_objects_changed(const vector<object_id_type>& ids, const impacted_accounts_cache& impacted_accounts);
       void on_objects_removed(const vector<object_id_type>& ids, const vector<const object*>& objs,
-                              const flat_set<account_id_type>& impacted_accounts);
+                              const impacted_accounts_cache& impacted_accounts);
       void on_applied_block();
 
       ////////////////////////////////////////////////
@@ -27,6 +27,7 @@
 
 #include <graphene/protocol/types.hpp>
 #include <graphene/protocol/confidential.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 
 #include <graphene/market_history/market_history_plugin.hpp>
 
@@ -409,6 +410,32 @@ namespace graphene { namespace app {
           */
          std::vector<net::potential_peer_record> get_potential_peers() const;
 
+         /**
+          * @brief Get the duration statistics of the steps of pushing and applying blocks since the node started
+          * @return a JSON object with, for every step, the number of times it was measured, the total and maximum
+          *         durations in microseconds, and a histogram whose bucket @c i counts the durations of less than
+          *         2^i microseconds not counted in a previous bucket
+          */
+         fc::variant_object get_block_phase_stats() const;
+
+         /**
+          * @brief Get the counters of the cache of public keys recovered from transaction signatures
+          */
+         signature_key_cache_stats get_signature_cache_stats() const;
+
+         /**
+          * @brief Get the number of transaction sizes computed, and reused without serializing the transaction again
+          */
+         packed_size_stats get_packed_size_stats() const;
+
+         /**
+          * @brief Get the duration statistics of the evaluation of operations since they are measured
+          * @return a JSON object with, for every type of operation evaluated, the statistics of its evaluation and
+          *         of its application, in the format of @ref get_block_phase_stats; empty unless the node runs with
+          *         enable-operation-timing
+          */
+         fc::variant_object get_operation_timing_stats() const;
+
       private:
          application& _app;
    };
@@ -522,10 +549,24 @@ namespace graphene { namespace app {
           */
          vector<account_asset_balance> get_asset_holders( std::string asset, uint32_t start, uint32_t limit  )const;
 
+         /**
+          * @brief Get a page of the holders of an asset, largest balance first, without skipping the previous pages
+          * @param asset The specific asset id or symbol
+          * @param start_amount The balance of the last holder of the previous page, null to start with the largest
+          *                     holder
+          * @param start_account The account of the last holder of the previous page, if null the page starts with
+          *                      the largest holder of at most @p start_amount
+          * @param limit Maximum limit must not exceed 100
+          * @return A list of asset holders for the specified asset, after the given holder
+          */
+         vector<account_asset_balance> get_asset_holders_after( std::string asset, optional<share_type> start_amount,
+                                                                optional<account_id_type> start_account,
+                                                                uint32_t limit )const;
+
          /**
           * @brief Get asset holders count for a specific asset
           * @param asset The specific asset id or symbol
-          * @return Holders count for the specified asset
+          * @return Number of accounts with a non-zero balance of the specified asset
           */
          int get_asset_holders_count( std::string asset )const;
 
@@ -536,9 +577,16 @@ namespace graphene { namespace app {
          vector<asset_holders> get_all_asset_holders() const;
 
       private:
+         /// Number of accounts with a non-zero balance of @p asset_id
+         uint64_t count_asset_holders( asset_id_type asset_id )const;
+         /// The non-zero balances of @p asset_id, largest first
+         const balances_by_asset_index::asset_balances& get_asset_balances( asset_id_type asset_id )const;
+
          graphene::app::application& _app;
          graphene::chain::database& _db;
          graphene::app::database_api database_api;
+         /// Holders count of every asset, null if the api_helper_indexes plugin is not enabled
+         const graphene::api_helper_indexes::asset_holders_count_index* _holders_count_index = nullptr;
    };
 
    /**
@@ -692,6 +740,10 @@ FC_API(graphene::app::network_node_api,
        (get_potential_peers)
        (get_advanced_node_parameters)
        (set_advanced_node_parameters)
+       (get_block_phase_stats)
+       (get_signature_cache_stats)
+       (get_packed_size_stats)
+       (get_operation_timing_stats)
      )
 FC_API(graphene::app::crypto_api,
        (blind)
@@ -704,6 +756,7 @@ FC_API(graphene::app::crypto_api,
      )
 FC_API(graphene::app::asset_api,
        (get_asset_holders)
+       (get_asset_holders_after)
 	   (get_asset_holders_count)
        (get_all_asset_holders)
      )
@@ -96,6 +96,23 @@ namespace graphene { namespace app {
      vector< order >             asks;
    };
 
+   /// The orders of one side of a market at the same price
+   struct order_book_level
+   {
+      string                     price;
+      string                     quote;
+      string                     base;
+      uint32_t                   orders = 0;
+   };
+
+   struct aggregated_order_book
+   {
+      string                     base;
+      string                     quote;
+      vector< order_book_level > bids;
+      vector< order_book_level > asks;
+   };
+
    struct market_ticker
    {
       time_point_sec             time;
@@ -158,6 +175,14 @@ namespace graphene { namespace app {
       optional<liquidity_pool_ticker_object> statistics;
    };
 
+   /// An exchange through liquidity pools, the pools in the order of the exchanges
+   struct liquidity_pool_route
+   {
+      vector<liquidity_pool_id_type> pools;
+      asset                          amount_to_sell;
+      asset                          amount_to_receive;
+   };
+
 } }
 
 FC_REFLECT( graphene::app::more_data,
@@ -189,6 +214,8 @@ FC_REFLECT( graphene::app::full_account,
 
 FC_REFLECT( graphene::app::order, (price)(quote)(base) );
 FC_REFLECT( graphene::app::order_book, (base)(quote)(bids)(asks) );
+FC_REFLECT( graphene::app::order_book_level, (price)(quote)(base)(orders) );
+FC_REFLECT( graphene::app::aggregated_order_book, (base)(quote)(bids)(asks) );
 FC_REFLECT( graphene::app::market_ticker,
             (time)(base)(quote)(latest)(lowest_ask)(highest_bid)(percent_change)(base_volume)(quote_volume) );
 FC_REFLECT( graphene::app::market_volume, (time)(base)(quote)(base_volume)(quote_volume) );
@@ -199,3 +226,4 @@ FC_REFLECT_DERIVED( graphene::app::extended_asset_object, (graphene::chain::asse
 
 FC_REFLECT_DERIVED( graphene::app::extended_liquidity_pool_object, (graphene::chain::liquidity_pool_object),
                     (statistics) );
+FC_REFLECT( graphene::app::liquidity_pool_route, (pools)(amount_to_sell)(amount_to_receive) );
@@ -614,6 +614,16 @@ class database_api
        */
       order_book get_order_book( const string& base, const string& quote, unsigned limit = 50 )const;
 
+      /**
+       * @brief Returns the order book for the market base:quote, with the orders at the same price aggregated
+       * @param base symbol name or ID of the base asset
+       * @param quote symbol name or ID of the quote asset
+       * @param limit number of price levels to retrieve, for bids and asks each, capped at 50
+       * @return Price levels of the market, best price first
+       */
+      aggregated_order_book get_aggregated_order_book( const string& base, const string& quote,
+                                                       unsigned limit = 50 )const;
+
       /**
        * @brief Returns vector of tickers sorted by reverse base_volume
        * Note: this API is experimental and subject to change in next releases
@@ -811,6 +821,26 @@ class database_api
             optional<asset_id_type> start_id = optional<asset_id_type>(),
             optional<bool> with_statistics = false )const;
 
+      /**
+       * @brief Find the liquidity pools to exchange through to receive the most of an asset for an amount of another
+       * @param asset_symbol_or_id_to_sell symbol name or ID of the asset to sell
+       * @param amount_to_sell amount of the asset to sell
+       * @param asset_symbol_or_id_to_receive symbol name or ID of the asset to receive
+       * @param max_pools the most pools to exchange through, not greater than the protocol limit
+       * @return The pools to use in a routed liquidity pool exchange, with the amount it would receive now,
+       *         or null if the assets are not connected by initialized pools
+       *
+       * @note
+       * 1. if one of the assets cannot be found, an error will be returned
+       * 2. @p max_pools can be omitted or be null, if so the default value 3 will be used
+       * 3. the amounts include the market fees of the assets and the taker fees of the pools
+       */
+      optional<liquidity_pool_route> get_liquidity_pool_route(
+            std::string asset_symbol_or_id_to_sell,
+            share_type amount_to_sell,
+            std::string asset_symbol_or_id_to_receive,
+            optional<uint8_t> max_pools = 3 )const;
+
       ///////////////
       // Witnesses //
       ///////////////
@@ -1175,6 +1205,7 @@ FC_API(graphene::app::database_api,
 
    // Markets / feeds
    (get_order_book)
+   (get_aggregated_order_book)
    (get_limit_orders)
    (get_limit_orders_by_account)
    (get_account_limit_orders)
@@ -1201,6 +1232,7 @@ FC_API(graphene::app::database_api,
    (get_liquidity_pools)
    (get_liquidity_pools_by_share_asset)
    (get_liquidity_pools_by_owner)
+   (get_liquidity_pool_route)
 
    // Witnesses
    (get_witnesses)
@@ -27,6 +27,8 @@
 #include <fc/io/raw.hpp>
 #include <fc/uint128.hpp>
 
+#include <boost/range/iterator_range.hpp>
+
 namespace graphene { namespace chain {
 
 share_type cut_fee(share_type a, uint16_t p)
@@ -289,9 +291,10 @@ void balances_by_account_index::object_modified( const object& after  )
    ids_being_modified.pop();
 }
 
-const map< asset_id_type, const account_balance_object* >& balances_by_account_index::get_account_balances( const account_id_type& acct )const
+const balances_by_account_index::account_balances& balances_by_account_index::get_account_balances(
+      const account_id_type& acct )const
 {
-   static const map< asset_id_type, const account_balance_object* > _empty;
+   static const account_balances _empty;
 
    if( balances.size() < (acct.instance.value >> bits) + 1 ) return _empty;
    return balances[acct.instance.value >> bits][acct.instance.value & mask];
@@ -306,6 +309,79 @@ const account_balance_object* balances_by_account_index::get_account_balance( co
    return itr->second;
 }
 
+constexpr size_t balances_by_asset_index::max_sorted_assets;
+
+void balances_by_asset_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const account_balance_object*>(&obj) ); // for debug only
+   add( static_cast<const account_balance_object&>(obj) );
+}
+
+void balances_by_asset_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const account_balance_object*>(&obj) ); // for debug only
+   remove( static_cast<const account_balance_object&>(obj) );
+}
+
+void balances_by_asset_index::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const account_balance_object*>(&before) ); // for debug only
+   remove( static_cast<const account_balance_object&>(before) );
+}
+
+void balances_by_asset_index::object_modified( const object& after )
+{
+   assert( dynamic_cast<const account_balance_object*>(&after) ); // for debug only
+   add( static_cast<const account_balance_object&>(after) );
+}
+
+void balances_by_asset_index::add( const account_balance_object& b )
+{
+   if( b.balance == 0 )
+      return;
+   auto itr = _sorted.find( b.asset_type );
+   if( itr != _sorted.end() )
+      itr->second.balances[ std::make_pair( b.balance, b.owner ) ] = &b;
+}
+
+void balances_by_asset_index::remove( const account_balance_object& b )
+{
+   if( b.balance == 0 )
+      return;
+   auto itr = _sorted.find( b.asset_type );
+   if( itr != _sorted.end() )
+      itr->second.balances.erase( std::make_pair( b.balance, b.owner ) );
+}
+
+const balances_by_asset_index::asset_balances& balances_by_asset_index::get_asset_balances( const database& db,
+                                                                                            asset_id_type asset )const
+{
+   auto itr = _sorted.find( asset );
+   if( itr != _sorted.end() )
+   {
+      _recently_used.splice( _recently_used.begin(), _recently_used, itr->second.last_use );
+      return itr->second.balances;
+   }
+
+   if( _sorted.size() >= max_sorted_assets )
+   {
+      _sorted.erase( _recently_used.back() );
+      _recently_used.pop_back();
+   }
+   _recently_used.push_front( asset );
+   sorted_asset& entry = _sorted[ asset ];
+   entry.last_use = _recently_used.begin();
+   asset_balances& sorted = entry.balances;
+   const auto& bal_idx = db.get_index_type< account_balance_index >().indices().get< by_asset_owner >();
+   const auto range = bal_idx.equal_range( boost::make_tuple( asset ) );
+   for( const account_balance_object& b : boost::make_iterator_range( range.first, range.second ) )
+   {
+      if( b.balance != 0 )
+         sorted.emplace( std::make_pair( b.balance, b.owner ), &b );
+   }
+   return sorted;
+}
+
 } } // graphene::chain
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_object,
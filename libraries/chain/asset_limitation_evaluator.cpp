@@ -81,79 +81,131 @@ void_result asset_limitation_update_evaluator::do_apply(const asset_limitation_o
     FC_CAPTURE_AND_RETHROW((op))
 }
 
+   namespace detail {
+
+      /**
+       * Verify that asset prices are published only by specially-named accounts
+       * which may or may not exist on the blockchain at the time of this evaluation
+       */
+      void verify_asset_price_publisher(const database &d, const account_id_type fee_payer) {
+         const auto &accounts_by_name = d.get_index_type<account_index>().indices().get<by_name>();
+
+         // A helper function to check whether the operation's fee paying account has a special name
+         auto publisher_is = [&accounts_by_name, &fee_payer](const std::string &account_name ) -> bool
+         {
+            auto itr_name = accounts_by_name.find(account_name);
+            if (itr_name == accounts_by_name.end()) {
+               return false;
+            }
+            bool match = itr_name->get_id() == fee_payer;
+            return match;
+         };
+
+         if( d.head_block_time() < HF_ASSET_PRICE_PUBLISHERS_TIME ) {
+            FC_ASSERT(publisher_is("meta1"),
+                      "Asset prices can be updated only by approved accounts");
+
+         } else {
+            FC_ASSERT(publisher_is("meta1") ||
+                         publisher_is("freedom") || publisher_is("peace") || publisher_is("love") ||
+                         publisher_is("unity") || publisher_is("abundance") || publisher_is("victory") ||
+                         publisher_is("awareness") || publisher_is("destiny") || publisher_is("strength") ||
+                         publisher_is("clarity") || publisher_is("truth"),
+                      "Asset prices can be updated only by approved accounts");
+
+         }
+      }
+
+      /**
+       * Verify that the asset is an existing asset whose price may be published
+       */
+      void verify_asset_price_symbol(const database &d, const string &symbol) {
+         const auto &asset_by_symbol = d.get_index_type<asset_index>().indices().get<by_symbol>();
+         auto asset_itr = asset_by_symbol.find(symbol);
+         FC_ASSERT(asset_itr != asset_by_symbol.end(),
+                   "${symbol} should exist on the blockchain", ("symbol", symbol));
+         const asset_object &asset = *asset_itr;
+         FC_ASSERT(!asset.is_market_issued(), "${symbol} must not be a market-issued asset", ("symbol", symbol));
+         FC_ASSERT(asset.id != d.get_core_asset().id, "${symbol} must not be the core asset", ("symbol", symbol));
+      }
+
+      /**
+       * Create or update the published price of an asset
+       */
+      void set_asset_price(database &d, const string &symbol, const price_ratio &usd_price,
+                           const time_point_sec current_time) {
+         const auto &asset_price_idx = d.get_index_type<asset_price_index>().indices().get<by_symbol>();
+         auto itr = asset_price_idx.find(symbol);
+         if (itr == asset_price_idx.end()) {
+            // Create the asset price if it does not exist
+            d.create<asset_price>([&symbol, &usd_price, &current_time](asset_price &p) {
+               p.symbol = symbol;
+               p.usd_price = usd_price;
+               p.publication_time = current_time;
+            });
+
+         } else {
+            // Update the asset price, if the object already exists
+            d.modify(*itr, [&usd_price, &current_time](asset_price &p) {
+               p.usd_price = usd_price;
+               p.publication_time = current_time;
+            });
+         }
+      }
+
+   } // namespace detail
+
    void_result asset_price_publish_evaluator::do_evaluate(const asset_price_publish_operation &op) {
        try {
-           database &d = db();
+           const database &d = db();
 
            // Non-negative price for the external asset is checked by the asset_price_publish_operation.validate()
 
-           // Verify that limitation asset update only with specially-named accounts
-           // which may or may not exist on the blockchain at the time of this evaluation
-           const auto &accounts_by_name = d.get_index_type<account_index>().indices().get<by_name>();
-           const account_id_type fee_payer = op.fee_paying_account;
-
-           // A helper function to check whether the operation's fee paying account has a special name
-           auto publisher_is = [&accounts_by_name, &fee_payer](const std::string &account_name ) -> bool
-           {
-               auto itr_name = accounts_by_name.find(account_name);
-               if (itr_name == accounts_by_name.end()) {
-                   return false;
-               }
-               bool match = itr_name->get_id() == fee_payer;
-               return match;
-            };
-
-            if( d.head_block_time() < HF_ASSET_PRICE_PUBLISHERS_TIME ) {
-               FC_ASSERT(publisher_is("meta1"),
-                         "Asset prices can be updated only by approved accounts");
-
-            } else {
-                FC_ASSERT(publisher_is("meta1") ||
-                             publisher_is("freedom") || publisher_is("peace") || publisher_is("love") ||
-                             publisher_is("unity") || publisher_is("abundance") || publisher_is("victory") ||
-                             publisher_is("awareness") || publisher_is("destiny") || publisher_is("strength") ||
-                             publisher_is("clarity") || publisher_is("truth"),
-                          "Asset prices can be updated only by approved accounts");
+           detail::verify_asset_price_publisher(d, op.fee_paying_account);
+           detail::verify_asset_price_symbol(d, op.symbol);
 
-            }
+           return void_result();
+       }
+       FC_CAPTURE_AND_RETHROW((op))
+   }
+
+   void_result asset_price_publish_evaluator::do_apply(const asset_price_publish_operation &op) {
+       try {
+           database &d = db();
 
-           // Verify that the asset is an existing asset
-           const auto &asset_by_symbol = d.get_index_type<asset_index>().indices().get<by_symbol>();
-           auto asset_itr = asset_by_symbol.find(op.symbol);
-           FC_ASSERT(asset_itr != asset_by_symbol.end(),
-                     "${symbol} should exist on the blockchain", ("symbol", op.symbol));
-           const asset_object &asset = *asset_itr;
-           FC_ASSERT(!asset.is_market_issued(), "${symbol} must not be a market-issued asset", ("symbol", op.symbol));
-           FC_ASSERT(asset.id != d.get_core_asset().id, "${symbol} must not be the core asset", ("symbol", op.symbol));
+           detail::set_asset_price(d, op.symbol, op.usd_price, d.head_block_time());
 
            return void_result();
        }
        FC_CAPTURE_AND_RETHROW((op))
    }
 
-   void_result asset_price_publish_evaluator::do_apply(const asset_price_publish_operation &op) {
+   void_result asset_price_publish_batch_evaluator::do_evaluate(const asset_price_publish_batch_operation &op) {
+       try {
+           const database &d = db();
+
+           FC_ASSERT(HARDFORK_ASSET_PRICE_BATCH_PASSED(d.head_block_time()),
+                     "Not allowed until the batched asset price publication hardfork");
+
+           // Non-negative prices are checked by the asset_price_publish_batch_operation.validate()
+
+           detail::verify_asset_price_publisher(d, op.fee_paying_account);
+           for (const auto &entry : op.usd_prices) {
+              detail::verify_asset_price_symbol(d, entry.first);
+           }
+
+           return void_result();
+       }
+       FC_CAPTURE_AND_RETHROW((op))
+   }
+
+   void_result asset_price_publish_batch_evaluator::do_apply(const asset_price_publish_batch_operation &op) {
        try {
            database &d = db();
 
            const time_point_sec current_time = d.head_block_time();
-           const string &asset_symbol = op.symbol;
-           const auto &asset_price_idx = d.get_index_type<asset_price_index>().indices().get<by_symbol>();
-           auto itr = asset_price_idx.find(asset_symbol);
-           if (itr == asset_price_idx.end()) {
-               // Create the asset price if it does not exist
-               d.create<asset_price>([&op, &current_time](asset_price &p) {
-                  p.symbol = op.symbol;
-                  p.usd_price = op.usd_price;
-                  p.publication_time = current_time;
-               });
-
-           } else {
-               // Update the asset price, if the object already exists
-               const asset_price *asset_price_to_update = &*itr;
-               d.modify(*asset_price_to_update, [&op, &current_time](asset_price &p) {
-                  p.usd_price = op.usd_price;
-                  p.publication_time = current_time;
-               });
+           for (const auto &entry : op.usd_prices) {
+              detail::set_asset_price(d, entry.first, entry.second, current_time);
            }
 
            return void_result();
@@ -0,0 +1,115 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/authority_cache.hpp>
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <tuple>
+
+namespace graphene { namespace chain {
+
+bool verified_authority_cache::verification::operator<( const verification& other )const
+{
+   return std::tie( required_active, required_owner, signature_keys, allow_non_immediate_owner, max_recursion )
+        < std::tie( other.required_active, other.required_owner, other.signature_keys,
+                    other.allow_non_immediate_owner, other.max_recursion );
+}
+
+void verified_authority_cache::object_inserted( const object& obj )
+{
+   // No successful verification consulted the new account, but failed checks of other indexes may now succeed
+   ++_authority_revision;
+}
+
+void verified_authority_cache::object_removed( const object& obj )
+{
+   ++_authority_revision;
+   forget( account_id_type( obj.id ) );
+}
+
+void verified_authority_cache::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const account_object*>(&before) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(before);
+   _authorities_being_modified = std::make_pair( a.owner, a.active );
+}
+
+void verified_authority_cache::object_modified( const object& after )
+{
+   if( !_authorities_being_modified.valid() )
+      return;
+   assert( dynamic_cast<const account_object*>(&after) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(after);
+   if( !( _authorities_being_modified->first == a.owner ) || !( _authorities_being_modified->second == a.active ) )
+   {
+      ++_authority_revision;
+      forget( a.id );
+   }
+   _authorities_being_modified.reset();
+}
+
+void verified_authority_cache::forget( account_id_type account )
+{
+   if( _consulted.find( account ) == _consulted.end() )
+      return;
+
+   for( auto itr = _verifications.begin(); itr != _verifications.end(); )
+   {
+      if( itr->second.find( account ) == itr->second.end() )
+      {
+         ++itr;
+         continue;
+      }
+      for( account_id_type consulted : itr->second )
+      {
+         auto count_itr = _consulted.find( consulted );
+         if( --count_itr->second == 0 )
+            _consulted.erase( count_itr );
+      }
+      itr = _verifications.erase( itr );
+   }
+}
+
+void verified_authority_cache::verify( const database& db, const signed_transaction& trx,
+                                       bool allow_non_immediate_owner, uint32_t max_recursion )
+{ try {
+   verification v;
+   vector<authority> other;
+   for( const auto& op : trx.operations )
+      operation_get_required_authorities( op, v.required_active, v.required_owner, other );
+   v.signature_keys = trx.get_signature_keys( db.get_chain_id() );
+   v.allow_non_immediate_owner = allow_non_immediate_owner;
+   v.max_recursion = max_recursion;
+
+   // Authorities given in the operations are rare, they are always verified
+   const bool cacheable = other.empty();
+   if( cacheable && _verifications.find( v ) != _verifications.end() )
+   {
+      ++_hits;
+      return;
+   }
+   ++_misses;
+
+   flat_set<account_id_type> consulted;
+   graphene::protocol::verify_authority( trx.operations, v.signature_keys,
+         [&db,&consulted]( account_id_type id ) { consulted.insert( id ); return &id(db).active; },
+         [&db,&consulted]( account_id_type id ) { consulted.insert( id ); return &id(db).owner; },
+         allow_non_immediate_owner,
+         max_recursion );
+   if( !cacheable )
+      return;
+
+   if( _verifications.size() >= max_verifications )
+   {
+      _verifications.clear();
+      _consulted.clear();
+   }
+   for( account_id_type id : consulted )
+      ++_consulted[id];
+   _verifications.emplace( std::move( v ), std::move( consulted ) );
+} FC_CAPTURE_AND_RETHROW( (trx) ) }
+
+} } // graphene::chain
@@ -0,0 +1,86 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/block_phase_timer.hpp>
+#include <graphene/protocol/operations.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace graphene { namespace chain {
+
+void block_phase_stats::record( const fc::microseconds& elapsed )
+{
+   ++count;
+   total += elapsed;
+   if( elapsed > max )
+      max = elapsed;
+
+   size_t bucket = 0;
+   for( int64_t us = elapsed.count(); us > 0 && bucket + 1 < histogram_size; us >>= 1 )
+      ++bucket;
+   ++histogram[bucket];
+}
+
+void block_phase_clock::trace_if_slow( const fc::microseconds& threshold, const char* what, uint32_t block_num )const
+{
+   const fc::microseconds elapsed = _last - _start;
+   if( threshold.count() == 0 || elapsed < threshold )
+      return;
+
+   std::stringstream phases;
+   for( size_t i = 0; i < block_phase_count; ++i )
+   {
+      if( _elapsed[i].count() != 0 )
+         phases << ' ' << fc::reflector<block_phase>::to_string( block_phase( i ) ) << '=' << _elapsed[i].count();
+   }
+   wlog( "Slow ${what} of block #${n}: ${t} us,${p}",
+         ("what", what)("n", block_num)("t", elapsed.count())("p", phases.str()) );
+}
+
+struct operation_type_name_visitor
+{
+   typedef std::string result_type;
+
+   template<typename Operation>
+   std::string operator()( const Operation& )const
+   {
+      const std::string name = fc::get_typename<Operation>::name();
+      const size_t pos = name.rfind( "::" );
+      return pos == std::string::npos ? name : name.substr( pos + 2 );
+   }
+};
+
+std::string operation_type_name( int64_t which )
+{
+   graphene::protocol::operation op;
+   op.set_which( which );
+   return op.visit( operation_type_name_visitor() );
+}
+
+void log_operation_timing_stats( const std::vector< operation_timing_stats >& stats, size_t count )
+{
+   std::vector< size_t > order;
+   for( size_t i = 0; i < stats.size(); ++i )
+   {
+      if( stats[i].evaluate.count > 0 )
+         order.push_back( i );
+   }
+   const auto total = [&stats]( size_t i ) { return stats[i].evaluate.total + stats[i].apply.total; };
+   std::sort( order.begin(), order.end(), [&total]( size_t a, size_t b ) { return total( a ) > total( b ); } );
+   if( order.size() > count )
+      order.resize( count );
+
+   for( size_t i : order )
+   {
+      const operation_timing_stats& s = stats[i];
+      ilog( "Operation ${op}: ${n} evaluated in ${e} us (max ${em} us), ${a} applied in ${t} us (max ${am} us)",
+            ("op", operation_type_name( i ))("n", s.evaluate.count)("e", s.evaluate.total.count())
+            ("em", s.evaluate.max.count())("a", s.apply.count)("t", s.apply.total.count())("am", s.apply.max.count()) );
+   }
+}
+
+} } // graphene::chain
@@ -23,6 +23,7 @@
  */
 
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/authority_cache.hpp>
 #include <graphene/chain/db_with.hpp>
 #include <graphene/chain/hardfork.hpp>
 
@@ -80,12 +81,29 @@ optional<signed_block> database::fetch_block_by_number( uint32_t num )const
       return _block_id_to_block.fetch_by_number(num);
 }
 
-const signed_transaction& database::get_recent_transaction(const transaction_id_type& trx_id) const
+optional<signed_transaction> database::get_recent_transaction(const transaction_id_type& trx_id) const
 {
    auto& index = get_index_type<transaction_index>().indices().get<by_trx_id>();
    auto itr = index.find(trx_id);
-   FC_ASSERT(itr != index.end());
-   return itr->trx;
+   if( itr == index.end() )
+      return {};
+
+   if( itr->block_num == 0 )
+   {
+      for( const processed_transaction& trx : _pending_tx )
+      {
+         if( trx.id() == trx_id )
+            return signed_transaction( trx );
+      }
+      return {};
+   }
+
+   optional<signed_block> block = fetch_block_by_number( itr->block_num );
+   // The block at that height may have been replaced by a fork, which can hold another transaction there
+   if( !block.valid() || block->transactions.size() <= itr->trx_in_block
+         || block->transactions[itr->trx_in_block].id() != trx_id )
+      return {};
+   return signed_transaction( block->transactions[itr->trx_in_block] );
 }
 
 std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const
@@ -116,14 +134,19 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
 {
 //   idump((new_block.block_num())(new_block.id())(new_block.timestamp)(new_block.previous));
    bool result;
+   block_phase_clock phase_clock( _block_phase_stats );
    detail::with_skip_flags( *this, skip, [&]()
    {
       detail::without_pending_transactions( *this, std::move(_pending_tx),
       [&]()
       {
+         phase_clock.lap( block_phase::pending_transactions_popped );
          result = _push_block(new_block);
+         phase_clock.lap( block_phase::block_push );
       });
    });
+   phase_clock.lap( block_phase::pending_transactions_restored );
+   phase_clock.trace_if_slow( _slow_block_threshold, "push", new_block.block_num() );
    return result;
 }
 
@@ -266,6 +289,13 @@ processed_transaction database::validate_transaction( const signed_transaction&
    return _apply_transaction( trx );
 }
 
+void database::verify_transaction_authority( const signed_transaction& trx )const
+{
+   bool allow_non_immediate_owner = ( head_block_time() >= HARDFORK_CORE_584_TIME );
+   _p_authority_cache->verify( *this, trx, allow_non_immediate_owner,
+                               get_global_properties().parameters.max_authority_depth );
+}
+
 class push_proposal_nesting_guard {
 public:
    push_proposal_nesting_guard( uint32_t& nesting_counter, const database& db )
@@ -314,7 +344,7 @@ processed_transaction database::push_proposal(const proposal_object& proposal)
       }
       else
       {
-         _applied_ops.resize( old_applied_ops_size );
+         _applied_ops.truncate( old_applied_ops_size );
       }
       wlog( "${e}", ("e",e.to_detail_string() ) );
       throw;
@@ -324,6 +354,11 @@ processed_transaction database::push_proposal(const proposal_object& proposal)
    return ptrx;
 } FC_CAPTURE_AND_RETHROW( (proposal) ) }
 
+bool database::is_proposal_authorized_to_execute( const proposal_object& proposal )
+{
+   return _p_required_approval_idx->is_authorized_to_execute( *this, proposal );
+}
+
 signed_block database::generate_block(
    fc::time_point_sec when,
    witness_id_type witness_id,
@@ -393,7 +428,7 @@ signed_block database::_generate_block(
    uint64_t postponed_tx_count = 0;
    for( const processed_transaction& tx : _pending_tx )
    {
-      size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
+      size_t new_total_size = total_block_size + tx.get_serialized_size();
 
       // postpone transaction if it would make block too big
       if( new_total_size > maximum_block_size )
@@ -410,7 +445,7 @@ signed_block database::_generate_block(
          // We have to recompute pack_size(ptx) because it may be different
          // than pack_size(tx) (i.e. if one or more results increased
          // their size)
-         new_total_size = total_block_size + fc::raw::pack_size( ptx );
+         new_total_size = total_block_size + ptx.get_serialized_size();
          // postpone transaction if it would make block too big
          if( new_total_size > maximum_block_size )
          {
@@ -420,7 +455,7 @@ signed_block database::_generate_block(
          temp_session.merge();
 
          total_block_size = new_total_size;
-         pending_block.transactions.push_back( ptx );
+         pending_block.transactions.push_back( std::move( ptx ) );
       }
       catch ( const fc::exception& e )
       {
@@ -484,14 +519,21 @@ void database::clear_pending()
 
 uint32_t database::push_applied_operation( const operation& op )
 {
-   _applied_ops.emplace_back(op);
-   operation_history_object& oh = *(_applied_ops.back());
+   operation_history_object& oh = _applied_ops.push_back(op);
    oh.block_num    = _current_block_num;
    oh.trx_in_block = _current_trx_in_block;
    oh.op_in_trx    = _current_op_in_trx;
    oh.virtual_op   = _current_virtual_op++;
    return _applied_ops.size() - 1;
 }
+void database::set_operation_timing_enabled( bool enabled )
+{
+   if( enabled )
+      _operation_timing_stats.resize( operation::count() );
+   else
+      _operation_timing_stats.clear();
+}
+
 void database::set_applied_operation_result( uint32_t op_id, const operation_result& result )
 {
    assert( op_id < _applied_ops.size() );
@@ -503,7 +545,7 @@ void database::set_applied_operation_result( uint32_t op_id, const operation_res
    }
 }
 
-const vector<optional< operation_history_object > >& database::get_applied_operations() const
+const applied_operation_journal& database::get_applied_operations() const
 {
    return _applied_ops;
 }
@@ -535,10 +577,11 @@ void database::_apply_block( const signed_block& next_block )
    uint32_t next_block_num = next_block.block_num();
    uint32_t skip = get_node_properties().skip_flags;
    _applied_ops.clear();
+   block_phase_clock phase_clock( _block_phase_stats );
 
    if( !(skip & skip_block_size_check) )
    {
-      FC_ASSERT( fc::raw::pack_size(next_block) <= get_global_properties().parameters.maximum_block_size );
+      FC_ASSERT( next_block.get_packed_size() <= get_global_properties().parameters.maximum_block_size );
    }
 
    FC_ASSERT( (skip & skip_merkle_check) || next_block.transaction_merkle_root == next_block.calculate_merkle_root(),
@@ -552,6 +595,7 @@ void database::_apply_block( const signed_block& next_block )
    const auto& global_props = get_global_properties();
    const auto& dynamic_global_props = get_dynamic_global_properties();
    bool maint_needed = (dynamic_global_props.next_maintenance_time <= next_block.timestamp);
+   phase_clock.lap( block_phase::header );
 
    // trx_in_block starts from 0.
    // For real operations which are explicitly included in a transaction, op_in_trx starts from 0, virtual_op is 0.
@@ -559,6 +603,7 @@ void database::_apply_block( const signed_block& next_block )
    //     use the real operation's (block_num,trx_in_block,op_in_trx), virtual_op starts from 1.
    // For virtual operations created after processed all transactions,
    //     trx_in_block = the_block.trsanctions.size(), op_in_trx is 0, virtual_op starts from 0.
+   detail::applying_block_flag applying_block( _applying_block );
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
 
@@ -575,6 +620,7 @@ void database::_apply_block( const signed_block& next_block )
       apply_transaction( trx, skip );
       ++_current_trx_in_block;
    }
+   phase_clock.lap( block_phase::transactions );
 
    _current_op_in_trx    = 0;
    _current_virtual_op   = 0;
@@ -583,20 +629,34 @@ void database::_apply_block( const signed_block& next_block )
    update_global_dynamic_data( next_block, missed );
    update_signing_witness(signing_witness, next_block);
    update_last_irreversible_block();
+   phase_clock.lap( block_phase::global_state );
 
    // Are we at the maintenance interval?
    if( maint_needed )
+   {
       perform_chain_maintenance(next_block, global_props);
+      phase_clock.lap( block_phase::maintenance );
+      if( !_operation_timing_stats.empty() )
+         log_operation_timing_stats( _operation_timing_stats, 10 );
+   }
 
    create_block_summary(next_block);
    clear_expired_transactions();
+   phase_clock.lap( block_phase::expired_transactions );
    clear_expired_proposals();
+   phase_clock.lap( block_phase::expired_proposals );
    clear_expired_orders();
+   phase_clock.lap( block_phase::expired_orders );
    clear_expired_htlcs();
+   phase_clock.lap( block_phase::expired_htlcs );
    update_expired_feeds();       // this will update expired feeds and some core exchange rates
+   phase_clock.lap( block_phase::expired_feeds );
    update_core_exchange_rates(); // this will update remaining core exchange rates
+   phase_clock.lap( block_phase::core_exchange_rates );
    update_withdraw_permissions();
+   phase_clock.lap( block_phase::withdraw_permissions );
    update_smooth_allocation();
+   phase_clock.lap( block_phase::smooth_allocation );
 
    // n.b., update_maintenance_flag() happens this late
    // because get_slot_time() / get_slot_at_time() is needed above
@@ -607,12 +667,16 @@ void database::_apply_block( const signed_block& next_block )
    update_witness_schedule();
    if( !_node_property_object.debug_updates.empty() )
       apply_debug_updates();
+   phase_clock.lap( block_phase::witness_schedule );
 
    // notify observers that the block has been applied
    notify_applied_block( next_block ); //emit
    _applied_ops.clear();
+   phase_clock.lap( block_phase::applied_block_signal );
 
    notify_changed_objects();
+   phase_clock.lap( block_phase::changed_objects_signal );
+   phase_clock.trace_if_slow( _slow_block_threshold, "application", next_block_num );
 } FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
 
 
@@ -634,7 +698,6 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    trx.validate();
 
    auto& trx_idx = get_mutable_index_type<transaction_index>();
-   const chain_id_type& chain_id = get_chain_id();
    if( !(skip & skip_transaction_dupe_check) )
    {
       GRAPHENE_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx.id()) == trx_idx.indices().get<by_trx_id>().end(),
@@ -648,18 +711,7 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
  
 
    if( !(skip & skip_transaction_signatures) )
-   { 
-      bool allow_non_immediate_owner = ( head_block_time() >= HARDFORK_CORE_584_TIME );
-      auto get_active = [&]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [&]( account_id_type id ) { return &id(*this).owner;  };
-
-      trx.verify_authority( chain_id,
-                            get_active,
-                            get_owner,
-                            allow_non_immediate_owner,
-                            get_global_properties().parameters.max_authority_depth );
-
-   }
+      verify_transaction_authority( trx );
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
    //expired, and TaPoS makes no sense as no blocks exist.
    if( BOOST_LIKELY(head_block_num() > 0) )
@@ -686,16 +738,23 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    //Insert transaction into unique transactions database.
    if( !(skip & skip_transaction_dupe_check) )
    {
-      create<transaction_history_object>([&trx](transaction_history_object& transaction) {
+      create<transaction_history_object>([this,&trx](transaction_history_object& transaction) {
          transaction.trx_id = trx.id();
-         transaction.trx = trx;
+         transaction.expiration = trx.expiration;
+         if( _applying_block )
+         {
+            transaction.block_num = _current_block_num;
+            transaction.trx_in_block = _current_trx_in_block;
+         }
       });
    }
 
    eval_state.operation_results.reserve(trx.operations.size());
 
-   //Finally process the operations
-   processed_transaction ptrx(trx);
+   //Finally process the operations, keeping what was already computed for a precomputable transaction
+   const auto* precomputed = dynamic_cast<const precomputable_transaction*>( &trx );
+   processed_transaction ptrx = ( precomputed != nullptr ? processed_transaction( *precomputed )
+                                                         : processed_transaction( trx ) );
    _current_op_in_trx = 0;
    for( const auto& op : ptrx.operations )
    {
@@ -714,10 +773,10 @@ operation_result database::apply_operation(transaction_evaluation_state& eval_st
    uint64_t u_which = uint64_t( i_which );
    FC_ASSERT( i_which >= 0, "Negative operation tag in operation ${op}", ("op",op) );
    FC_ASSERT( u_which < _operation_evaluators.size(), "No registered evaluator for operation ${op}", ("op",op) );
-   unique_ptr<op_evaluator>& eval = _operation_evaluators[ u_which ];
-   FC_ASSERT( eval, "No registered evaluator for operation ${op}", ("op",op) );
+   const operation_evaluation_function evaluate = _operation_evaluators[ u_which ];
+   FC_ASSERT( evaluate != nullptr, "No registered evaluator for operation ${op}", ("op",op) );
    auto op_id = push_applied_operation( op );
-   auto result = eval->evaluate( eval_state, op, true );
+   auto result = evaluate( eval_state, op, true );
    set_applied_operation_result( op_id, result );
    return result;
 } FC_CAPTURE_AND_RETHROW( (op) ) }
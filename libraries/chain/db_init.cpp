@@ -27,6 +27,7 @@
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/authority_cache.hpp>
 #include <graphene/chain/balance_object.hpp>
 #include <graphene/chain/block_summary_object.hpp>
 #include <graphene/chain/budget_record_object.hpp>
@@ -37,12 +38,16 @@
 #include <graphene/chain/fba_object.hpp>
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/liquidity_pool_object.hpp>
+#include <graphene/chain/margin_call_index.hpp>
 #include <graphene/chain/market_object.hpp>
 #include <graphene/chain/operation_history_object.hpp>
+#include <graphene/chain/order_book_index.hpp>
 #include <graphene/chain/proposal_object.hpp>
+#include <graphene/chain/top_holders_index.hpp>
 #include <graphene/chain/special_authority_object.hpp>
 #include <graphene/chain/transaction_history_object.hpp>
 #include <graphene/chain/vesting_balance_object.hpp>
+#include <graphene/chain/vote_tally_index.hpp>
 #include <graphene/chain/withdraw_permission_object.hpp>
 #include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/witness_schedule_object.hpp>
@@ -142,7 +147,7 @@ const uint8_t asset_limitation_object::type_id;
 
 void database::initialize_evaluators()
 {
-   _operation_evaluators.resize(255);
+   _operation_evaluators.resize(255, nullptr);
    register_evaluator<account_create_evaluator>();
    register_evaluator<account_update_evaluator>();
    register_evaluator<account_upgrade_evaluator>();
@@ -195,11 +200,13 @@ void database::initialize_evaluators()
    register_evaluator<asset_limitation_create_evaluator>();
    register_evaluator<asset_limitation_update_evaluator>();
    register_evaluator<asset_price_publish_evaluator>();
+   register_evaluator<asset_price_publish_batch_evaluator>();
    register_evaluator<liquidity_pool_create_evaluator>();
    register_evaluator<liquidity_pool_delete_evaluator>();
    register_evaluator<liquidity_pool_deposit_evaluator>();
    register_evaluator<liquidity_pool_withdraw_evaluator>();
    register_evaluator<liquidity_pool_exchange_evaluator>();
+   register_evaluator<liquidity_pool_route_exchange_evaluator>();
 }
 
 void database::initialize_indexes()
@@ -211,14 +218,20 @@ void database::initialize_indexes()
    add_index< primary_index<asset_index, 13> >(); // 8192 assets per chunk
    add_index< primary_index<force_settlement_index> >();
 
-   add_index< primary_index<account_index, 20> >(); // ~1 million accounts per chunk
+   auto acnt_idx = add_index< primary_index<account_index, 20> >(); // ~1 million accounts per chunk
+   _p_vote_tally_idx = acnt_idx->add_secondary_index<vote_tally_index>();
+   _p_authority_cache = acnt_idx->add_secondary_index<verified_authority_cache>();
    add_index< primary_index<committee_member_index, 8> >(); // 256 members per chunk
    add_index< primary_index<witness_index, 10> >(); // 1024 witnesses per chunk
-   add_index< primary_index<limit_order_index > >();
-   add_index< primary_index<call_order_index > >();
-   add_index< primary_index<proposal_index > >();
+   auto limit_order_idx = add_index< primary_index<limit_order_index > >();
+   _p_order_book_idx = limit_order_idx->add_secondary_index<order_book_index>();
+   auto call_order_idx = add_index< primary_index<call_order_index > >();
+   _p_margin_call_idx = call_order_idx->add_secondary_index<margin_call_index>();
+   auto proposal_idx = add_index< primary_index<proposal_index > >();
+   _p_required_approval_idx = proposal_idx->add_secondary_index<required_approval_index>( _p_authority_cache );
    add_index< primary_index<withdraw_permission_index > >();
-   add_index< primary_index<vesting_balance_index> >();
+   auto vbo_idx = add_index< primary_index<vesting_balance_index> >();
+   vbo_idx->add_secondary_index< vote_stake_watcher<vesting_balance_object> >( _p_vote_tally_idx );
    add_index< primary_index<worker_index> >();
    add_index< primary_index<balance_index> >();
    add_index< primary_index<blinded_balance_index> >();
@@ -232,12 +245,15 @@ void database::initialize_indexes()
    add_index< primary_index<transaction_index                             > >();
 
    auto bal_idx = add_index< primary_index<account_balance_index          > >();
-   bal_idx->add_secondary_index<balances_by_account_index>();
+   _p_balances_by_account_idx = bal_idx->add_secondary_index<balances_by_account_index>();
+   bal_idx->add_secondary_index<balances_by_asset_index>();
+   _p_top_holders_idx = bal_idx->add_secondary_index<top_holders_index>();
 
    add_index< primary_index<asset_bitasset_data_index,                 13 > >(); // 8192
    add_index< primary_index<simple_index<global_property_object          >> >();
    add_index< primary_index<simple_index<dynamic_global_property_object  >> >();
-   add_index< primary_index<account_stats_index,                       20 > >(); // 1 Mi
+   auto stats_idx = add_index< primary_index<account_stats_index,                       20 > >(); // 1 Mi
+   stats_idx->add_secondary_index< vote_stake_watcher<account_statistics_object> >( _p_vote_tally_idx );
    add_index< primary_index<simple_index<asset_dynamic_data_object       >> >();
    add_index< primary_index<simple_index<block_summary_object            >> >();
    add_index< primary_index<simple_index<chain_property_object          > > >();
@@ -272,6 +288,15 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
    transaction_evaluation_state genesis_eval_state(this);
 
+   // Log the duration of the steps, a large genesis state takes a while to load
+   fc::time_point step_start = fc::time_point::now();
+   const auto log_step = [&step_start]( const char* step, size_t count ) {
+      const fc::time_point now = fc::time_point::now();
+      ilog( "Genesis: ${step} (${n}) in ${t} milliseconds",
+            ("step", step)("n", count)("t", (now - step_start).count() / 1000) );
+      step_start = now;
+   };
+
    // Create blockchain accounts
    fc::ecc::private_key null_private_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")));
    create<account_balance_object>([&genesis_state](account_balance_object& b) {
@@ -460,6 +485,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
    } );
    for (uint32_t i = 0; i <= 0x10000; i++)
       create<block_summary_object>( [&]( block_summary_object&) {});
+   log_step( "created special objects", 0x10001 );
 
    // Create initial accounts
    for( const auto& account : genesis_state.initial_accounts )
@@ -487,7 +513,11 @@ void database::init_genesis(const genesis_state_type& genesis_state)
           op.upgrade_to_lifetime_member = true;
           apply_operation(genesis_eval_state, op);
       }
+
+      // Nobody is notified of the operations applied by the genesis, do not keep them
+      _applied_ops.clear();
    }
+   log_step( "created initial accounts", genesis_state.initial_accounts.size() );
 
    // Helper function to get account ID by name
    const auto& accounts_by_name = get_index_type<account_index>().indices().get<by_name>();
@@ -579,6 +609,8 @@ void database::init_genesis(const genesis_state_type& genesis_state)
          a.bitasset_data_id = bitasset_data_id;
       });
    }
+   _applied_ops.clear();
+   log_step( "created initial assets", genesis_state.initial_assets.size() );
 
    // Create initial balances
    share_type total_allocation;
@@ -592,6 +624,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
       total_supplies[ asset_id ] += handout.amount;
    }
+   log_step( "created initial balances", genesis_state.initial_balances.size() );
 
    // Create initial vesting balances
    for( const genesis_state_type::initial_vesting_balance_type& vest : genesis_state.initial_vesting_balances )
@@ -612,6 +645,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
       total_supplies[ asset_id ] += vest.amount;
    }
+   log_step( "created initial vesting balances", genesis_state.initial_vesting_balances.size() );
 
    if( total_supplies[ asset_id_type(0) ] > 0 )
    {
@@ -699,6 +733,9 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
        apply_operation(genesis_eval_state, std::move(op));
    });
+   log_step( "created initial witnesses, committee members and workers",
+             genesis_state.initial_witness_candidates.size() + genesis_state.initial_committee_candidates.size()
+             + genesis_state.initial_worker_candidates.size() );
 
    // Set active witnesses
    modify(get_global_properties(), [&genesis_state](global_property_object& p) {
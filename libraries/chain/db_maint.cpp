@@ -23,6 +23,7 @@
  */
 
 #include <fc/uint128.hpp>
+#include <fc/thread/parallel.hpp>
 
 #include <graphene/protocol/market.hpp>
 
@@ -40,8 +41,10 @@
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/market_object.hpp>
 #include <graphene/chain/special_authority_object.hpp>
+#include <graphene/chain/top_holders_index.hpp>
 #include <graphene/chain/vesting_balance_object.hpp>
 #include <graphene/chain/vote_count.hpp>
+#include <graphene/chain/vote_tally_index.hpp>
 #include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/worker_object.hpp>
 #include <graphene/chain/property_object.hpp>
@@ -73,7 +76,7 @@ vector<std::reference_wrapper<const typename Index::object_type>> database::sort
 }
 
 template<class Type>
-void database::perform_account_maintenance(Type tally_helper)
+void database::perform_account_maintenance(Type& tally_helper)
 {
    const auto& bal_idx = get_index_type< account_balance_index >().indices().get< by_maintenance_flag >();
    if( bal_idx.begin() != bal_idx.end() )
@@ -98,17 +101,50 @@ void database::perform_account_maintenance(Type tally_helper)
    const auto& stats_idx = get_index_type< account_stats_index >().indices().get< by_maintenance_seq >();
    auto stats_itr = stats_idx.lower_bound( true );
 
+   if( head_block_time() < HARDFORK_VOTE_TALLY_SNAPSHOT_TIME )
+   {
+      while( stats_itr != stats_idx.end() )
+      {
+         const account_statistics_object& acc_stat = *stats_itr;
+         const account_object& acc_obj = acc_stat.owner( *this );
+         ++stats_itr;
+
+         if( acc_stat.has_some_core_voting() )
+            tally_helper( acc_obj, acc_stat );
+
+         if( acc_stat.has_pending_fees() )
+            acc_stat.process_fees( acc_obj, *this );
+      }
+      return;
+   }
+
+   // After the hard fork, votes are tallied before any pending fee is paid out, so that the tally does not depend
+   // on cashback deposited by accounts earlier in the sequence.
+   if( get_global_properties().parameters.count_non_member_votes )
+   {
+      // The running tally only needs to visit the accounts whose stake changed since the previous maintenance
+      _p_vote_tally_idx->update( *this );
+      tally_helper.assign( *_p_vote_tally_idx );
+   }
+   else
+   {
+      // Membership depends on time, so every voter is tallied again, spread over several threads
+      vector<const account_statistics_object*> voters;
+      for( auto itr = stats_itr; itr != stats_idx.end(); ++itr )
+      {
+         if( itr->has_some_core_voting() )
+            voters.push_back( &(*itr) );
+      }
+      tally_helper.tally_all( voters );
+   }
+
    while( stats_itr != stats_idx.end() )
    {
       const account_statistics_object& acc_stat = *stats_itr;
-      const account_object& acc_obj = acc_stat.owner( *this );
       ++stats_itr;
 
-      if( acc_stat.has_some_core_voting() )
-         tally_helper( acc_obj, acc_stat );
-
       if( acc_stat.has_pending_fees() )
-         acc_stat.process_fees( acc_obj, *this );
+         acc_stat.process_fees( acc_stat.owner( *this ), *this );
    }
 
 }
@@ -565,40 +601,59 @@ void visit_special_authorities( const database& db, Visitor visit )
    }
 }
 
-void update_top_n_authorities( database& db )
+void database::update_top_n_authorities()
 {
-   visit_special_authorities( db,
+   // the number of holders needed by the special authorities of each asset, plus the account itself
+   flat_map< asset_id_type, uint16_t > holder_counts;
+   visit_special_authorities( *this,
+   [&]( const account_object&, bool, const special_authority& auth )
+   {
+      if( auth.is_type< top_holders_special_authority >() )
+      {
+         const top_holders_special_authority& tha = auth.get< top_holders_special_authority >();
+         uint16_t& count = holder_counts[ tha.asset ];
+         count = std::max< uint16_t >( count, uint16_t( tha.num_top_holders ) + 1 );
+      }
+   } );
+   _p_top_holders_idx->track( holder_counts );
+
+   visit_special_authorities( *this,
    [&]( const account_object& acct, bool is_owner, const special_authority& auth )
    {
       if( auth.is_type< top_holders_special_authority >() )
       {
-         // use index to grab the top N holders of the asset and vote_counter to obtain the weights
+         // use the largest holders of the asset, kept by the index, and vote_counter to obtain the weights
 
          const top_holders_special_authority& tha = auth.get< top_holders_special_authority >();
          vote_counter vc;
-         const auto& bal_idx = db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
          uint8_t num_needed = tha.num_top_holders;
          if( num_needed == 0 )
             return;
 
-         // find accounts
-         const auto range = bal_idx.equal_range( boost::make_tuple( tha.asset ) );
-         for( const account_balance_object& bal : boost::make_iterator_range( range.first, range.second ) )
+         // find accounts, holders without a balance have no weight
+         for( const auto& holder : _p_top_holders_idx->get_top_holders( *this, tha.asset ) )
          {
-             assert( bal.asset_type == tha.asset );
-             if( bal.owner == acct.id )
+             if( holder.second == acct.id )
                 continue;
-             vc.add( bal.owner, bal.balance.value );
+             vc.add( holder.second, holder.first.value );
              --num_needed;
              if( num_needed == 0 )
                 break;
          }
+         if( vc.is_empty() )
+            return;
+
+         // the authority is only modified when the holders or their weights changed
+         const uint8_t flag = ( is_owner ? account_object::top_n_control_owner : account_object::top_n_control_active );
+         authority auth_after = ( is_owner ? acct.owner : acct.active );
+         vc.finish( auth_after );
+         if( ( acct.top_n_control_flags & flag ) && auth_after == ( is_owner ? acct.owner : acct.active ) )
+            return;
 
-         db.modify( acct, [&]( account_object& a )
+         modify( acct, [&]( account_object& a )
          {
-            vc.finish( is_owner ? a.owner : a.active );
-            if( !vc.is_empty() )
-               a.top_n_control_flags |= (is_owner ? account_object::top_n_control_owner : account_object::top_n_control_active);
+            ( is_owner ? a.owner : a.active ) = std::move( auth_after );
+            a.top_n_control_flags |= flag;
          } );
       }
    } );
@@ -708,11 +763,17 @@ void create_buyback_orders( database& db )
          continue;
       }
 
+      // The orders create the balance of the asset to buy on their first fill, which inserts into the flat map of the
+      // balances of the account, so the balances to sell are copied before placing any order.
+      // Only the asset to buy is received, so the balances of the other assets do not change meanwhile.
+      vector< pair< asset_id_type, share_type > > holdings;
       for( const auto& entry : bal_idx.get_account_balances( buyback_account.id ) )
+         holdings.emplace_back( entry.first, entry.second->balance );
+
+      for( const auto& holding : holdings )
       {
-         const auto* it = entry.second;
-         asset_id_type asset_to_sell = it->asset_type;
-         share_type amount_to_sell = it->balance;
+         asset_id_type asset_to_sell = holding.first;
+         share_type amount_to_sell = holding.second;
          if( asset_to_sell == asset_to_buy.id )
             continue;
          if( amount_to_sell == 0 )
@@ -1152,22 +1213,86 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    distribute_fba_balances(*this);
    create_buyback_orders(*this);
 
+   /// Votes tallied from a subset of the voting accounts
+   struct vote_tally_shard {
+      vector<uint64_t> vote_tally;
+      vector<uint64_t> witness_count_histogram;
+      vector<uint64_t> committee_count_histogram;
+      uint64_t         total_voting_stake = 0;
+
+      explicit vote_tally_shard( const global_property_object& gpo )
+         : vote_tally( gpo.next_available_vote_id ),
+           witness_count_histogram( gpo.parameters.maximum_witness_count / 2 + 1 ),
+           committee_count_histogram( gpo.parameters.maximum_committee_count / 2 + 1 )
+      {}
+
+      void merge( const vote_tally_shard& other )
+      {
+         for( size_t i = 0; i < vote_tally.size(); ++i )
+            vote_tally[i] += other.vote_tally[i];
+         for( size_t i = 0; i < witness_count_histogram.size(); ++i )
+            witness_count_histogram[i] += other.witness_count_histogram[i];
+         for( size_t i = 0; i < committee_count_histogram.size(); ++i )
+            committee_count_histogram[i] += other.committee_count_histogram[i];
+         total_voting_stake += other.total_voting_stake;
+      }
+   };
+
    struct vote_tally_helper {
       database& d;
       const global_property_object& props;
+      const time_point_sec now;
+      vote_tally_shard totals;
 
       vote_tally_helper(database& d, const global_property_object& gpo)
-         : d(d), props(gpo)
+         : d(d), props(gpo), now(d.head_block_time()), totals(gpo)
+      {}
+
+      void operator()( const account_object& stake_account, const account_statistics_object& stats )
       {
-         d._vote_tally_buffer.resize(props.next_available_vote_id);
-         d._witness_count_histogram_buffer.resize(props.parameters.maximum_witness_count / 2 + 1);
-         d._committee_count_histogram_buffer.resize(props.parameters.maximum_committee_count / 2 + 1);
-         d._total_voting_stake = 0;
+         tally( stake_account, stats, totals );
       }
 
-      void operator()( const account_object& stake_account, const account_statistics_object& stats )
+      /// Tally the given voters, possibly in parallel. Reads the database only.
+      void tally_all( const vector<const account_statistics_object*>& voters )
+      {
+         // Below this number of voters per thread, the overhead of a thread outweighs the work it saves
+         const size_t min_voters_per_shard = 4096;
+         const size_t max_chunks = voters.size() / min_voters_per_shard;
+         const size_t chunks = std::min( size_t( fc::asio::default_io_service_scope::get_num_threads() ), max_chunks );
+         if( chunks <= 1 )
+         {
+            for( const account_statistics_object* stats : voters )
+               tally( stats->owner( d ), *stats, totals );
+            return;
+         }
+
+         const size_t chunk_size = ( voters.size() + chunks - 1 ) / chunks;
+         vector<vote_tally_shard> shards( chunks, vote_tally_shard( props ) );
+         std::vector<fc::future<void>> workers;
+         workers.reserve( chunks );
+         for( size_t i = 0; i < chunks; ++i )
+         {
+            const size_t base = i * chunk_size;
+            const size_t end = std::min( base + chunk_size, voters.size() );
+            vote_tally_shard& shard = shards[i];
+            workers.push_back( fc::do_parallel( [this,&voters,&shard,base,end] () {
+               for( size_t j = base; j < end; ++j )
+                  tally( voters[j]->owner( d ), *voters[j], shard );
+            }) );
+         }
+         for( auto& worker : workers )
+            worker.wait();
+
+         // Reduce in a fixed order, independent of the number of threads
+         for( const vote_tally_shard& shard : shards )
+            totals.merge( shard );
+      }
+
+      void tally( const account_object& stake_account, const account_statistics_object& stats,
+                  vote_tally_shard& out )const
       {
-         if( props.parameters.count_non_member_votes || stake_account.is_member(d.head_block_time()) )
+         if( props.parameters.count_non_member_votes || stake_account.is_member(now) )
          {
             // There may be a difference between the account whose stake is voting and the one specifying opinions.
             // Usually they're the same, but if the stake account has specified a voting_account, that account is the one
@@ -1185,39 +1310,58 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
             {
                uint32_t offset = id.instance();
                // if they somehow managed to specify an illegal offset, ignore it.
-               if( offset < d._vote_tally_buffer.size() )
-                  d._vote_tally_buffer[offset] += voting_stake;
+               if( offset < out.vote_tally.size() )
+                  out.vote_tally[offset] += voting_stake;
             }
 
             if( opinion_account.options.num_witness <= props.parameters.maximum_witness_count )
             {
                uint16_t offset = std::min(size_t(opinion_account.options.num_witness/2),
-                                          d._witness_count_histogram_buffer.size() - 1);
+                                          out.witness_count_histogram.size() - 1);
                // votes for a number greater than maximum_witness_count
                // are turned into votes for maximum_witness_count.
                //
                // in particular, this takes care of the case where a
                // member was voting for a high number, then the
                // parameter was lowered.
-               d._witness_count_histogram_buffer[offset] += voting_stake;
+               out.witness_count_histogram[offset] += voting_stake;
             }
             if( opinion_account.options.num_committee <= props.parameters.maximum_committee_count )
             {
                uint16_t offset = std::min(size_t(opinion_account.options.num_committee/2),
-                                          d._committee_count_histogram_buffer.size() - 1);
+                                          out.committee_count_histogram.size() - 1);
                // votes for a number greater than maximum_committee_count
                // are turned into votes for maximum_committee_count.
                //
                // same rationale as for witnesses
-               d._committee_count_histogram_buffer[offset] += voting_stake;
+               out.committee_count_histogram[offset] += voting_stake;
             }
 
-            d._total_voting_stake += voting_stake;
+            out.total_voting_stake += voting_stake;
          }
       }
+
+      /// Take the tally from the running tally of the votes
+      void assign( const vote_tally_index& running_tally )
+      {
+         totals.vote_tally = running_tally.get_vote_tally();
+         totals.witness_count_histogram = running_tally.get_witness_count_histogram();
+         totals.committee_count_histogram = running_tally.get_committee_count_histogram();
+         totals.total_voting_stake = running_tally.get_total_voting_stake();
+      }
+
+      /// Hand the tally over to the database for the rest of the maintenance
+      void finish()
+      {
+         d._vote_tally_buffer = std::move( totals.vote_tally );
+         d._witness_count_histogram_buffer = std::move( totals.witness_count_histogram );
+         d._committee_count_histogram_buffer = std::move( totals.committee_count_histogram );
+         d._total_voting_stake = totals.total_voting_stake;
+      }
    } tally_helper(*this, gpo);
 
    perform_account_maintenance( tally_helper );
+   tally_helper.finish();
 
    struct clear_canary {
       clear_canary(vector<uint64_t>& target): target(target){}
@@ -1229,7 +1373,7 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
                 b(_committee_count_histogram_buffer),
                 c(_vote_tally_buffer);
 
-   update_top_n_authorities(*this);
+   update_top_n_authorities();
    update_active_witnesses();
    update_active_committee_members();
    update_worker_votes();
@@ -28,7 +28,9 @@
 #include <graphene/chain/asset_object.hpp>
 #include <graphene/chain/property_object.hpp>
 #include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/margin_call_index.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/order_book_index.hpp>
 #include <graphene/chain/is_authorized_asset.hpp>
 
 #include <fc/uint128.hpp>
@@ -221,7 +223,8 @@ void database::cancel_settle_order(const force_settlement_object& order, bool cr
    remove(order);
 }
 
-void database::cancel_limit_order( const limit_order_object& order, bool create_virtual_op, bool skip_cancel_fee )
+void database::cancel_limit_order( const limit_order_object& order, bool create_virtual_op, bool skip_cancel_fee,
+                                   limit_order_refunds* refunds )
 {
    // if need to create a virtual op, try deduct a cancellation fee here.
    // there are two scenarios when order is cancelled and need to create a virtual op:
@@ -281,6 +284,25 @@ void database::cancel_limit_order( const limit_order_object& order, bool create_
 
    // refund funds in order
    auto refunded = order.amount_for_sale();
+   if( refunds != nullptr )
+   {
+      // the refunds are paid by the caller, once for all the orders of the same account and asset
+      if( refunded.asset_id == asset_id_type() )
+         refunds->core_in_orders[ order.seller ] += refunded.amount;
+      refunds->add_balance( order.seller, refunded );
+      if( order.deferred_paid_fee.amount == 0 )
+         refunds->add_balance( order.seller, asset( deferred_fee ) );
+      else
+      {
+         refunds->add_balance( order.seller, deferred_paid_fee );
+         refunds->fee_pools[ deferred_paid_fee.asset_id ] += deferred_fee;
+      }
+      if( create_virtual_op )
+         push_applied_operation( vop );
+      remove( order );
+      return;
+   }
+
    if( refunded.asset_id == asset_id_type() )
    {
       if( seller_acc_stats == nullptr )
@@ -317,6 +339,48 @@ void database::cancel_limit_order( const limit_order_object& order, bool create_
    remove(order);
 }
 
+void database::limit_order_refunds::add_balance( account_id_type account, const asset& amount )
+{
+   if( amount.amount != 0 )
+      balances[ std::make_pair( account, amount.asset_id ) ] += amount.amount;
+}
+
+uint32_t database::cancel_expired_limit_orders( uint32_t max_count )
+{
+   const auto head_time = head_block_time();
+   const auto& limit_index = get_index_type<limit_order_index>().indices().get<by_expiration>();
+   limit_order_refunds refunds;
+   uint32_t count = 0;
+   while( count < max_count && !limit_index.empty() && limit_index.begin()->expiration <= head_time )
+   {
+      cancel_limit_order( *limit_index.begin(), true, false, &refunds );
+      ++count;
+   }
+
+   for( const auto& core : refunds.core_in_orders )
+      modify( get_account_stats_by_owner( core.first ), [&core]( account_statistics_object& obj ) {
+         obj.total_core_in_orders -= core.second;
+      });
+   for( const auto& balance : refunds.balances )
+      adjust_balance( balance.first.first, asset( balance.second, balance.first.second ) );
+   for( const auto& pool : refunds.fee_pools )
+      modify( pool.first( *this ).dynamic_asset_data_id( *this ), [&pool]( asset_dynamic_data_object& addo ) {
+         addo.fee_pool += pool.second;
+      });
+
+   return count;
+}
+
+bool database::cancel_limit_order_if_expired( const limit_order_object& order )
+{
+   const auto head_time = head_block_time();
+   if( head_time < HARDFORK_EXPIRED_ORDER_BATCH_TIME || order.expiration > head_time )
+      return false;
+   // Hard fork 606 has passed, so cancelling the order does not need to check the call orders
+   cancel_limit_order( order );
+   return true;
+}
+
 bool maybe_cull_small_order( database& db, const limit_order_object& order )
 {
    /**
@@ -401,20 +465,20 @@ bool database::apply_order(const limit_order_object& new_order_object, bool allo
    asset_id_type recv_asset_id = new_order_object.receive_asset_id();
 
    // We only need to check if the new order will match with others if it is at the front of the book
+   if( !_p_order_book_idx->is_first_in_line( new_order_object ) )
+      return false;
+
+   // this is the opposite side (on the book), only searched if its best price level can be matched
    const auto& limit_price_idx = get_index_type<limit_order_index>().indices().get<by_price>();
-   auto limit_itr = limit_price_idx.lower_bound( boost::make_tuple( new_order_object.sell_price, order_id ) );
-   if( limit_itr != limit_price_idx.begin() )
+   auto max_price = ~new_order_object.sell_price;
+   auto limit_itr = limit_price_idx.end();
+   auto limit_end = limit_itr;
+   if( _p_order_book_idx->is_crossed_by( new_order_object.sell_price ) )
    {
-      --limit_itr;
-      if( limit_itr->sell_asset_id() == sell_asset_id && limit_itr->receive_asset_id() == recv_asset_id )
-         return false;
+      limit_itr = limit_price_idx.lower_bound( max_price.max() );
+      limit_end = limit_price_idx.upper_bound( max_price );
    }
 
-   // this is the opposite side (on the book)
-   auto max_price = ~new_order_object.sell_price;
-   limit_itr = limit_price_idx.lower_bound( max_price.max() );
-   auto limit_end = limit_price_idx.upper_bound( max_price );
-
    // Order matching should be in favor of the taker.
    // When a new limit order is created, e.g. an ask, need to check if it will match the highest bid.
    // We were checking call orders first. However, due to MSSR (maximum_short_squeeze_ratio),
@@ -478,6 +542,8 @@ bool database::apply_order(const limit_order_object& new_order_object, bool allo
       {
          auto old_limit_itr = limit_itr;
          ++limit_itr;
+         if( cancel_limit_order_if_expired( *old_limit_itr ) )
+            continue;
          // match returns 2 when only the old order was fully filled. In this case, we keep matching; otherwise, we stop.
          finished = ( match( new_order_object, *old_limit_itr, old_limit_itr->sell_price ) != 2 );
       }
@@ -485,20 +551,17 @@ bool database::apply_order(const limit_order_object& new_order_object, bool allo
       if( !finished && !before_core_hardfork_1270 ) // TODO refactor or cleanup duplicate code after core-1270 hard fork
       {
          // check if there are margin calls
-         const auto& call_collateral_idx = get_index_type<call_order_index>().indices().get<by_collateral>();
-         auto call_min = price::min( recv_asset_id, sell_asset_id );
          while( !finished )
          {
             // hard fork core-343 and core-625 took place at same time,
             // always check call order with least collateral ratio
-            auto call_itr = call_collateral_idx.lower_bound( call_min );
-            if( call_itr == call_collateral_idx.end()
-                  || call_itr->debt_type() != sell_asset_id
+            const call_order_object* call_ptr = _p_margin_call_idx->get_least_collateralized( sell_asset_id );
+            if( call_ptr == nullptr
                   // feed protected https://github.com/cryptonomex/graphene/issues/436
-                  || call_itr->collateralization() > sell_abd->current_maintenance_collateralization )
+                  || call_ptr->collateralization() > sell_abd->current_maintenance_collateralization )
                break;
             // hard fork core-338 and core-625 took place at same time, not checking HARDFORK_CORE_338_TIME here.
-            int match_result = match( new_order_object, *call_itr, call_match_price,
+            int match_result = match( new_order_object, *call_ptr, call_match_price,
                                       sell_abd->current_feed.settlement_price,
                                       sell_abd->current_feed.maintenance_collateral_ratio,
                                       sell_abd->current_maintenance_collateralization );
@@ -540,6 +603,8 @@ bool database::apply_order(const limit_order_object& new_order_object, bool allo
    {
       auto old_limit_itr = limit_itr;
       ++limit_itr;
+      if( cancel_limit_order_if_expired( *old_limit_itr ) )
+         continue;
       // match returns 2 when only the old order was fully filled. In this case, we keep matching; otherwise, we stop.
       finished = ( match( new_order_object, *old_limit_itr, old_limit_itr->sell_price ) != 2 );
    }
@@ -996,11 +1061,16 @@ bool database::check_call_orders( const asset_object& mia, bool enable_black_swa
     if( bitasset.is_prediction_market ) return false;
     if( bitasset.current_feed.settlement_price.is_null() ) return false;
 
+    bool before_core_hardfork_1270 = ( maint_time <= HARDFORK_CORE_1270_TIME ); // call price caching issue
+
+    // Feed protected (don't call if CR>MCR), nothing to look for in the order books when even the least
+    // collateralized position is above the maintenance collateralization
+    if( !before_core_hardfork_1270 && !_p_margin_call_idx->has_callable_position( bitasset ) )
+       return false;
+
     const limit_order_index& limit_index = get_index_type<limit_order_index>();
     const auto& limit_price_index = limit_index.indices().get<by_price>();
 
-    bool before_core_hardfork_1270 = ( maint_time <= HARDFORK_CORE_1270_TIME ); // call price caching issue
-
     // looking for limit orders selling the most USD for the least CORE
     auto max_price = price::max( mia.id, bitasset.options.short_backing_asset );
     // stop when limit orders are selling too little USD for too much CORE
@@ -1068,6 +1138,14 @@ bool database::check_call_orders( const asset_object& mia, bool enable_black_swa
                    && after_hardfork_436 && bitasset.current_feed.settlement_price > ~call_order.call_price ) )
           return margin_called;
 
+       // the expired orders which the bounded batches did not cancel yet are not filled by margin calls
+       auto limit_after = std::next( limit_itr );
+       if( cancel_limit_order_if_expired( *limit_itr ) )
+       {
+          limit_itr = limit_after;
+          continue;
+       }
+
        const limit_order_object& limit_order = *limit_itr;
        price match_price  = limit_order.sell_price;
        // There was a check `match_price.validate();` here, which is removed now because it always passes
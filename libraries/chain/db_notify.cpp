@@ -307,6 +307,10 @@ struct get_impacted_account_visitor
    {
       _impacted.insert(op.fee_payer());
    }
+   void operator()(const asset_price_publish_batch_operation &op)
+   {
+      _impacted.insert(op.fee_payer());
+   }
    void operator()( const liquidity_pool_create_operation& op )
    {
       _impacted.insert( op.fee_payer() ); // account
@@ -327,6 +331,10 @@ struct get_impacted_account_visitor
    {
       _impacted.insert( op.fee_payer() ); // account
    }
+   void operator()( const liquidity_pool_route_exchange_operation& op )
+   {
+      _impacted.insert( op.fee_payer() ); // account
+   }
 
 };
 
@@ -461,12 +469,9 @@ void get_relevant_accounts( const object* obj, flat_set<account_id_type>& accoun
               FC_ASSERT( aobj != nullptr );
               accounts.insert( aobj->owner );
               break;
-           } case impl_transaction_history_object_type:{
-              const auto& aobj = dynamic_cast<const transaction_history_object*>(obj);
-              FC_ASSERT( aobj != nullptr );
-              transaction_get_impacted_accounts( aobj->trx, accounts );
+           } case impl_transaction_history_object_type:
               break;
-           } case impl_blinded_balance_object_type:{
+             case impl_blinded_balance_object_type:{
               const auto& aobj = dynamic_cast<const blinded_balance_object*>(obj);
               FC_ASSERT( aobj != nullptr );
               for( const auto& a : aobj->owner.account_auths )
@@ -503,6 +508,20 @@ void get_relevant_accounts( const object* obj, flat_set<account_id_type>& accoun
    }
 } // end get_relevant_accounts( const object* obj, flat_set<account_id_type>& accounts )
 
+const flat_set<account_id_type>& graphene::chain::impacted_accounts_cache::get()const
+{
+   if( !_accounts.valid() )
+   {
+      _accounts = flat_set<account_id_type>();
+      for( const object* obj : _objects )
+      {
+         if( obj != nullptr )
+            get_relevant_accounts( obj, *_accounts );
+      }
+   }
+   return *_accounts;
+}
+
 namespace graphene { namespace chain {
 
 void database::notify_applied_block( const signed_block& block )
@@ -525,32 +544,36 @@ void database::notify_changed_objects()
       if( !new_objects.empty() )
       {
         vector<object_id_type> new_ids;  new_ids.reserve(head_undo.new_ids.size());
-        flat_set<account_id_type> new_accounts_impacted;
+        vector<const object*> created;  created.reserve(head_undo.new_ids.size());
         for( const auto& item : head_undo.new_ids )
         {
           new_ids.push_back(item);
-          auto obj = find_object(item);
-          if(obj != nullptr)
-            get_relevant_accounts(obj, new_accounts_impacted);
+          created.push_back( find_object(item) );
         }
 
         if( new_ids.size() )
+        {
+           const impacted_accounts_cache new_accounts_impacted( created );
            GRAPHENE_TRY_NOTIFY( new_objects, new_ids, new_accounts_impacted)
+        }
       }
 
       // Changed
       if( !changed_objects.empty() )
       {
         vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
-        flat_set<account_id_type> changed_accounts_impacted;
+        vector<const object*> changed;  changed.reserve(head_undo.old_values.size());
         for( const auto& item : head_undo.old_values )
         {
           changed_ids.push_back(item.first);
-          get_relevant_accounts(item.second.get(), changed_accounts_impacted);
+          changed.push_back( item.second.get() );
         }
 
         if( changed_ids.size() )
+        {
+           const impacted_accounts_cache changed_accounts_impacted( changed );
            GRAPHENE_TRY_NOTIFY( changed_objects, changed_ids, changed_accounts_impacted)
+        }
       }
 
       // Removed
@@ -558,17 +581,17 @@ void database::notify_changed_objects()
       {
         vector<object_id_type> removed_ids; removed_ids.reserve( head_undo.removed.size() );
         vector<const object*> removed; removed.reserve( head_undo.removed.size() );
-        flat_set<account_id_type> removed_accounts_impacted;
         for( const auto& item : head_undo.removed )
         {
           removed_ids.emplace_back( item.first );
-          auto obj = item.second.get();
-          removed.emplace_back( obj );
-          get_relevant_accounts(obj, removed_accounts_impacted);
+          removed.emplace_back( item.second.get() );
         }
 
         if( removed_ids.size() )
+        {
+           const impacted_accounts_cache removed_accounts_impacted( removed );
            GRAPHENE_TRY_NOTIFY( removed_objects, removed_ids, removed, removed_accounts_impacted)
+        }
       }
    }
 } FC_CAPTURE_AND_LOG( (0) ) }
@@ -29,6 +29,7 @@
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/htlc_object.hpp>
+#include <graphene/chain/margin_call_index.hpp>
 #include <graphene/chain/market_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/transaction_history_object.hpp>
@@ -147,19 +148,25 @@ void database::clear_expired_transactions()
    auto& transaction_idx = static_cast<transaction_index&>(get_mutable_index(implementation_ids,
                                                                              impl_transaction_history_object_type));
    const auto& dedupe_index = transaction_idx.indices().get<by_expiration>();
-   while( (!dedupe_index.empty()) && (head_block_time() > dedupe_index.begin()->trx.expiration) )
+   while( (!dedupe_index.empty()) && (head_block_time() > dedupe_index.begin()->expiration) )
       transaction_idx.remove(*dedupe_index.begin());
 } FC_CAPTURE_AND_RETHROW() }
 
 void database::clear_expired_proposals()
 {
+   // After the hard fork, a block handles a bounded batch of the expired proposals, earliest expiration first,
+   // and the rest are handled by the next blocks in the same order
+   const bool bounded = HARDFORK_EXPIRATION_SWEEP_PASSED( head_block_time() );
+   uint32_t count = 0;
    const auto& proposal_expiration_index = get_index_type<proposal_index>().indices().get<by_expiration>();
-   while( !proposal_expiration_index.empty() && proposal_expiration_index.begin()->expiration_time <= head_block_time() )
+   while( !proposal_expiration_index.empty() && proposal_expiration_index.begin()->expiration_time <= head_block_time()
+          && ( !bounded || count < GRAPHENE_MAX_EXPIRED_PROPOSALS_PER_BLOCK ) )
    {
+      ++count;
       const proposal_object& proposal = *proposal_expiration_index.begin();
       processed_transaction result;
       try {
-         if( proposal.is_authorized_to_execute(*this) )
+         if( is_proposal_authorized_to_execute(proposal) )
          {
             result = push_proposal(proposal);
             //TODO: Do something with result so plugins can process it.
@@ -210,11 +217,9 @@ bool database::check_for_blackswan( const asset_object& mia, bool enable_black_s
     }
     else // after core-1270 hard fork, check with collateralization
     {
-       const auto& call_collateral_index = get_index_type<call_order_index>().indices().get<by_collateral>();
-       auto call_itr = call_collateral_index.lower_bound( call_min );
-       if( call_itr == call_collateral_index.end() ) // no call order
+       call_ptr = _p_margin_call_idx->get_least_collateralized( debt_asset_id );
+       if( call_ptr == nullptr ) // no call order
           return false;
-       call_ptr = &(*call_itr);
     }
     if( call_ptr->debt_type() != debt_asset_id ) // no call order
        return false;
@@ -281,22 +286,32 @@ void database::clear_expired_orders()
          bool before_core_hardfork_342 = ( maint_time <= HARDFORK_CORE_342_TIME ); // better rounding
          bool before_core_hardfork_606 = ( maint_time <= HARDFORK_CORE_606_TIME ); // feed always trigger call
 
-         auto& limit_index = get_index_type<limit_order_index>().indices().get<by_expiration>();
-         while( !limit_index.empty() && limit_index.begin()->expiration <= head_time )
+         if( head_time >= HARDFORK_EXPIRED_ORDER_BATCH_TIME )
+         {
+            // Cancel a bounded batch of the expired orders, earliest expiration first, and pay the refunds once per
+            // account and asset. What is left is cancelled by the next blocks in the same order.
+            // Hard fork 606 has passed, so cancelling the orders no longer needs to check the call orders.
+            cancel_expired_limit_orders( GRAPHENE_MAX_EXPIRED_LIMIT_ORDERS_PER_BLOCK );
+         }
+         else
          {
-            const limit_order_object& order = *limit_index.begin();
-            auto base_asset = order.sell_price.base.asset_id;
-            auto quote_asset = order.sell_price.quote.asset_id;
-            cancel_limit_order( order );
-            if( before_core_hardfork_606 )
+            auto& limit_index = get_index_type<limit_order_index>().indices().get<by_expiration>();
+            while( !limit_index.empty() && limit_index.begin()->expiration <= head_time )
             {
-               // check call orders
-               // Comments below are copied from limit_order_cancel_evaluator::do_apply(...)
-               // Possible optimization: order can be called by cancelling a limit order
-               //   if the canceled order was at the top of the book.
-               // Do I need to check calls in both assets?
-               check_call_orders( base_asset( *this ) );
-               check_call_orders( quote_asset( *this ) );
+               const limit_order_object& order = *limit_index.begin();
+               auto base_asset = order.sell_price.base.asset_id;
+               auto quote_asset = order.sell_price.quote.asset_id;
+               cancel_limit_order( order );
+               if( before_core_hardfork_606 )
+               {
+                  // check call orders
+                  // Comments below are copied from limit_order_cancel_evaluator::do_apply(...)
+                  // Possible optimization: order can be called by cancelling a limit order
+                  //   if the canceled order was at the top of the book.
+                  // Do I need to check calls in both assets?
+                  check_call_orders( base_asset( *this ) );
+                  check_call_orders( quote_asset( *this ) );
+               }
             }
          }
 
@@ -586,10 +601,15 @@ void database::update_withdraw_permissions()
 
 void database::clear_expired_htlcs()
 {
+   // After the hard fork, a block refunds a bounded batch of the expired HTLCs, see clear_expired_proposals
+   const bool bounded = HARDFORK_EXPIRATION_SWEEP_PASSED( head_block_time() );
+   uint32_t count = 0;
    const auto& htlc_idx = get_index_type<htlc_index>().indices().get<by_expiration>();
    while ( htlc_idx.begin() != htlc_idx.end()
-         && htlc_idx.begin()->conditions.time_lock.expiration <= head_block_time() )
+         && htlc_idx.begin()->conditions.time_lock.expiration <= head_block_time()
+         && ( !bounded || count < GRAPHENE_MAX_EXPIRED_HTLCS_PER_BLOCK ) )
    {
+      ++count;
       const htlc_object& obj = *htlc_idx.begin();
       adjust_balance( obj.transfer.from, asset(obj.transfer.amount, obj.transfer.asset_id) );
       // virtual op
@@ -43,9 +43,25 @@ database& generic_evaluator::db()const { return trx_state->db(); }
    { try {
       trx_state   = &eval_state;
       //check_required_authorities(op);
+      operation_timing_stats* timing = db().operation_timing_stats_for( op.which() );
+      if( timing == nullptr )
+      {
+         auto result = evaluate( op );
+
+         if( apply ) result = this->apply( op );
+         return result;
+      }
+
+      const fc::time_point start = fc::time_point::now();
       auto result = evaluate( op );
+      const fc::time_point evaluated = fc::time_point::now();
+      timing->evaluate.record( evaluated - start );
 
-      if( apply ) result = this->apply( op );
+      if( apply )
+      {
+         result = this->apply( op );
+         timing->apply.record( fc::time_point::now() - evaluated );
+      }
       return result;
    } FC_CAPTURE_AND_RETHROW() }
 
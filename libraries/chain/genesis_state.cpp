@@ -26,6 +26,7 @@
 #include <graphene/protocol/fee_schedule.hpp>
 
 #include <fc/io/raw.hpp>
+#include <fc/thread/parallel.hpp>
 
 namespace graphene { namespace chain {
 
@@ -76,3 +77,63 @@ GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::genesis_state_type::
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::genesis_state_type::initial_committee_member_type )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::genesis_state_type::initial_worker_type )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::genesis_state_type )
+
+// Below the reflection of the genesis state, which the conversions need
+namespace graphene { namespace chain {
+
+namespace {
+   /// Entries converted by one task
+   const size_t genesis_chunk_size = 10000;
+
+   template<typename T>
+   void convert_in_chunks( const fc::variant& var, vector<T>& result, uint32_t max_depth )
+   {
+      const fc::variants& entries = var.get_array();
+      result.resize( entries.size() );
+
+      std::vector<fc::future<void>> workers;
+      workers.reserve( ( entries.size() + genesis_chunk_size - 1 ) / genesis_chunk_size );
+      for( size_t base = 0; base < entries.size(); base += genesis_chunk_size )
+      {
+         const size_t end = std::min( base + genesis_chunk_size, entries.size() );
+         workers.push_back( fc::do_parallel( [&entries,&result,base,end,max_depth] () {
+            for( size_t i = base; i < end; ++i )
+               fc::from_variant( entries[i], result[i], max_depth );
+         }) );
+      }
+      for( auto& worker : workers )
+         worker.wait();
+   }
+}
+
+genesis_state_type load_genesis_state( const fc::variant& var, uint32_t max_depth )
+{ try {
+   FC_ASSERT( max_depth > 2, "Recursion depth exceeded" );
+   const fc::variant_object& obj = var.get_object();
+
+   // Convert everything but the large arrays as usual
+   fc::mutable_variant_object rest;
+   for( const auto& entry : obj )
+   {
+      if( entry.key() != "initial_accounts" && entry.key() != "initial_balances"
+            && entry.key() != "initial_vesting_balances" )
+         rest( entry.key(), entry.value() );
+   }
+   genesis_state_type result = fc::variant( rest ).as<genesis_state_type>( max_depth );
+
+   // The entries of an array are two levels below the genesis state
+   const uint32_t entry_depth = max_depth - 2;
+   auto itr = obj.find( "initial_accounts" );
+   if( itr != obj.end() )
+      convert_in_chunks( itr->value(), result.initial_accounts, entry_depth );
+   itr = obj.find( "initial_balances" );
+   if( itr != obj.end() )
+      convert_in_chunks( itr->value(), result.initial_balances, entry_depth );
+   itr = obj.find( "initial_vesting_balances" );
+   if( itr != obj.end() )
+      convert_in_chunks( itr->value(), result.initial_vesting_balances, entry_depth );
+
+   return result;
+} FC_CAPTURE_AND_RETHROW() }
+
+} } // graphene::chain
@@ -100,6 +100,9 @@ namespace graphene {
       void_result htlc_redeem_evaluator::do_evaluate(const htlc_redeem_operation& o)
       {
          htlc_obj = &db().get<htlc_object>(o.htlc_id);
+         // expired HTLCs may wait a few blocks to be refunded, see clear_expired_htlcs
+         if( HARDFORK_EXPIRATION_SWEEP_PASSED( db().head_block_time() ) )
+            FC_ASSERT( htlc_obj->conditions.time_lock.expiration > db().head_block_time(), "HTLC has expired." );
 
          FC_ASSERT(o.preimage.size() == htlc_obj->conditions.hash_lock.preimage_size, "Preimage size mismatch.");
          const htlc_redeem_visitor vtor( o.preimage );
@@ -124,6 +127,8 @@ namespace graphene {
       {
          htlc_obj = &db().get<htlc_object>(o.htlc_id);
          FC_ASSERT(o.update_issuer == htlc_obj->transfer.from, "HTLC may only be extended by its creator.");
+         if( HARDFORK_EXPIRATION_SWEEP_PASSED( db().head_block_time() ) )
+            FC_ASSERT( htlc_obj->conditions.time_lock.expiration > db().head_block_time(), "HTLC has expired." );
          optional<htlc_options> htlc_options = get_committee_htlc_options(db());
          FC_ASSERT( htlc_obj->conditions.time_lock.expiration.sec_since_epoch() 
                + static_cast<uint64_t>(o.seconds_to_add) < fc::time_point_sec::maximum().sec_since_epoch(), 
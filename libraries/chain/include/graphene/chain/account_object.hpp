@@ -29,6 +29,8 @@
 
 #include <boost/multi_index/composite_key.hpp>
 
+#include <list>
+
 namespace graphene { namespace chain {
    class database;
    class account_object;
@@ -327,16 +329,21 @@ namespace graphene { namespace chain {
    /**
     *  @brief This secondary index will allow fast access to the balance objects
     *         that belonging to an account.
+    *
+    *  The balances of an account are kept in a flat vector sorted by asset, which is small for most accounts and
+    *  is searched without following pointers.
     */
    class balances_by_account_index : public secondary_index
    {
       public:
+         typedef flat_map< asset_id_type, const account_balance_object* > account_balances;
+
          virtual void object_inserted( const object& obj ) override;
          virtual void object_removed( const object& obj ) override;
          virtual void about_to_modify( const object& before ) override;
          virtual void object_modified( const object& after  ) override;
 
-         const map< asset_id_type, const account_balance_object* >& get_account_balances( const account_id_type& acct )const;
+         const account_balances& get_account_balances( const account_id_type& acct )const;
          const account_balance_object* get_account_balance( const account_id_type& acct, const asset_id_type& asset )const;
 
       private:
@@ -344,11 +351,68 @@ namespace graphene { namespace chain {
          static const uint64_t mask;
 
          /** Maps each account to its balance objects */
-         vector< vector< map< asset_id_type, const account_balance_object* > > > balances;
+         vector< vector< account_balances > > balances;
          std::stack< object_id_type > ids_being_modified;
    };
 
-   struct by_asset_balance;
+   /**
+    *  @brief This secondary index keeps the non-zero balances of an asset sorted by amount, largest first.
+    *
+    *  The balances of an asset are only sorted once they are requested. From then on they follow every change of
+    *  the balances, including when it is undone. The balances of the other assets change without being sorted again.
+    *
+    *  At most max_sorted_assets assets are kept sorted. When another one is requested, the sorted balances of the
+    *  asset requested least recently are dropped, and sorted again if they are requested again.
+    */
+   class balances_by_asset_index : public secondary_index
+   {
+      public:
+         struct balance_compare
+         {
+            bool operator()( const std::pair<share_type, account_id_type>& a,
+                             const std::pair<share_type, account_id_type>& b )const
+            {
+               return a.first > b.first || ( a.first == b.first && a.second < b.second );
+            }
+         };
+         /// The balance objects of an asset by amount and owner, largest amount first
+         typedef std::map< std::pair<share_type, account_id_type>, const account_balance_object*, balance_compare >
+                 asset_balances;
+
+         /// Maximum number of assets whose balances are kept sorted
+         static constexpr size_t max_sorted_assets = 100;
+
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /**
+          *  The non-zero balances of @p asset, sorted the first time they are requested.
+          *  The reference is valid until the balances of another asset are requested.
+          */
+         const asset_balances& get_asset_balances( const database& db, asset_id_type asset )const;
+
+         size_t get_sorted_asset_count()const { return _sorted.size(); }
+         bool has_sorted_balances( asset_id_type asset )const { return _sorted.find( asset ) != _sorted.end(); }
+
+      private:
+         struct sorted_asset
+         {
+            asset_balances                           balances;
+            std::list<asset_id_type>::iterator       last_use;
+         };
+
+         void add( const account_balance_object& b );
+         void remove( const account_balance_object& b );
+
+         /// The sorted balances of the assets requested recently
+         mutable std::map< asset_id_type, sorted_asset > _sorted;
+         /// The assets whose balances are sorted, the most recently requested first
+         mutable std::list< asset_id_type >               _recently_used;
+   };
+
+   struct by_asset_owner;
    struct by_maintenance_flag;
    /**
     * @ingroup object_index
@@ -359,17 +423,11 @@ namespace graphene { namespace chain {
          ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
          ordered_non_unique< tag<by_maintenance_flag>,
                              member< account_balance_object, bool, &account_balance_object::maintenance_flag > >,
-         ordered_unique< tag<by_asset_balance>,
+         ordered_unique< tag<by_asset_owner>,
             composite_key<
                account_balance_object,
                member<account_balance_object, asset_id_type, &account_balance_object::asset_type>,
-               member<account_balance_object, share_type, &account_balance_object::balance>,
                member<account_balance_object, account_id_type, &account_balance_object::owner>
-            >,
-            composite_key_compare<
-               std::less< asset_id_type >,
-               std::greater< share_type >,
-               std::less< account_id_type >
             >
          >
       >
@@ -0,0 +1,93 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/chain/operation_history_object.hpp>
+
+#include <array>
+#include <iterator>
+#include <memory>
+
+namespace graphene { namespace chain {
+
+   /**
+    *  @brief The operations applied in the current block, real and virtual.
+    *
+    *  Entries are stored in fixed size chunks which are kept from one block to the next, so that recording an
+    *  operation neither moves the entries already recorded nor allocates storage for the entry once the journal has
+    *  grown to the size of a typical block. References to entries stay valid until they are truncated.
+    *
+    *  An entry is empty if its operation was removed, see @ref database::push_proposal.
+    */
+   class applied_operation_journal
+   {
+      public:
+         typedef optional<operation_history_object> value_type;
+
+         class const_iterator
+         {
+            public:
+               typedef std::forward_iterator_tag iterator_category;
+               typedef applied_operation_journal::value_type value_type;
+               typedef std::ptrdiff_t            difference_type;
+               typedef const value_type*         pointer;
+               typedef const value_type&         reference;
+
+               const_iterator( const applied_operation_journal& journal, size_t index )
+                  : _journal( &journal ), _index( index ) {}
+
+               reference operator*()const { return (*_journal)[_index]; }
+               pointer operator->()const { return &(*_journal)[_index]; }
+               const_iterator& operator++() { ++_index; return *this; }
+               const_iterator operator++(int) { const_iterator result( *this ); ++_index; return result; }
+               bool operator==( const const_iterator& other )const { return _index == other._index; }
+               bool operator!=( const const_iterator& other )const { return _index != other._index; }
+
+            private:
+               const applied_operation_journal* _journal;
+               size_t                           _index;
+         };
+
+         /// Record an operation, and return its entry
+         operation_history_object& push_back( const operation& op )
+         {
+            if( _size == _chunks.size() * chunk_size )
+               _chunks.emplace_back( new chunk() );
+            value_type& entry = (*this)[_size];
+            entry = operation_history_object( op );
+            ++_size;
+            return *entry;
+         }
+
+         /// Remove the entries from @p new_size on
+         void truncate( size_t new_size )
+         {
+            for( size_t i = new_size; i < _size; ++i )
+               (*this)[i].reset();
+            if( new_size < _size )
+               _size = new_size;
+         }
+
+         void clear() { truncate( 0 ); }
+
+         size_t size()const { return _size; }
+         bool   empty()const { return _size == 0; }
+
+         value_type& operator[]( size_t index )
+         { return (*_chunks[index / chunk_size])[index % chunk_size]; }
+         const value_type& operator[]( size_t index )const
+         { return (*_chunks[index / chunk_size])[index % chunk_size]; }
+
+         const_iterator begin()const { return const_iterator( *this, 0 ); }
+         const_iterator end()const { return const_iterator( *this, _size ); }
+
+      private:
+         static constexpr size_t chunk_size = 256;
+         typedef std::array< value_type, chunk_size > chunk;
+
+         vector< std::unique_ptr< chunk > > _chunks;
+         size_t                             _size = 0;
+   };
+
+} } // graphene::chain
@@ -36,5 +36,14 @@ public:
       void_result do_apply(const asset_price_publish_operation &o);
    };
 
+   class asset_price_publish_batch_evaluator : public evaluator<asset_price_publish_batch_evaluator> {
+   public:
+      typedef asset_price_publish_batch_operation operation_type;
+
+      void_result do_evaluate(const asset_price_publish_batch_operation &o);
+
+      void_result do_apply(const asset_price_publish_batch_operation &o);
+   };
+
 } // namespace chain
 } // namespace graphene
\ No newline at end of file
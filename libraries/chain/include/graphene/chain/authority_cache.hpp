@@ -0,0 +1,81 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/db/generic_index.hpp>
+#include <graphene/protocol/authority.hpp>
+#include <graphene/protocol/transaction.hpp>
+
+#include <map>
+
+namespace graphene { namespace chain {
+   class database;
+
+   /**
+    *  @brief This secondary index remembers the transaction signatures that were found to satisfy the authorities
+    *         required by the transaction.
+    *
+    *  The verification of the signatures of a transaction only depends on the authorities required by its operations,
+    *  on the keys recovered from its signatures, on the verification parameters, and on the owner and active
+    *  authorities of the accounts consulted while resolving them. Accounts that transact many times, with the same
+    *  signers, are only resolved once.
+    *
+    *  It is attached to the account index. A verification is forgotten as soon as the owner or active authority of
+    *  an account it consulted changes, including when the change is undone, or when the account is removed. Failed
+    *  verifications are not remembered.
+    *
+    *  It also counts the changes of the owner and active authorities of all accounts, including the creation of
+    *  accounts, so that other checks of authorities can tell whether one of them changed since they were made. An
+    *  authority naming an account that did not exist yet can be satisfied once the account is created.
+    */
+   class verified_authority_cache : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// Verify the signatures of @p trx, unless the same verification already succeeded
+         void verify( const database& db, const signed_transaction& trx, bool allow_non_immediate_owner,
+                      uint32_t max_recursion );
+
+         uint64_t get_hits()const { return _hits; }
+         uint64_t get_misses()const { return _misses; }
+
+         /// Number of changes of the owner or active authority of any account, including creations, removals and undos
+         uint64_t get_authority_revision()const { return _authority_revision; }
+
+      private:
+         struct verification
+         {
+            flat_set<account_id_type> required_active;
+            flat_set<account_id_type> required_owner;
+            flat_set<public_key_type> signature_keys;
+            bool                      allow_non_immediate_owner = false;
+            uint32_t                  max_recursion = 0;
+
+            bool operator<( const verification& other )const;
+         };
+
+         /// Maximum number of verifications remembered, all are forgotten when it is reached
+         static constexpr size_t max_verifications = 10000;
+
+         void forget( account_id_type account );
+
+         /// The successful verifications, and the accounts whose authorities they consulted
+         std::map< verification, flat_set<account_id_type> > _verifications;
+         /// The number of verifications consulting each account
+         std::map< account_id_type, uint32_t >               _consulted;
+
+         /// Authorities of the account being modified
+         optional< std::pair< authority, authority > >       _authorities_being_modified;
+
+         uint64_t _hits = 0;
+         uint64_t _misses = 0;
+         uint64_t _authority_revision = 0;
+   };
+
+} } // graphene::chain
@@ -0,0 +1,130 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace graphene { namespace chain {
+
+   /// The steps of pushing and applying a block whose duration is measured
+   enum class block_phase : uint8_t
+   {
+      header,                       ///< block size, merkle root and block header checks
+      transactions,
+      global_state,                 ///< missed blocks, global properties, signing witness, last irreversible block
+      maintenance,
+      expired_transactions,         ///< block summary and expired transactions
+      expired_proposals,
+      expired_orders,
+      expired_htlcs,
+      expired_feeds,
+      core_exchange_rates,
+      withdraw_permissions,
+      smooth_allocation,
+      witness_schedule,             ///< maintenance flag, witness schedule and debug updates
+      applied_block_signal,         ///< observers of applied_block
+      changed_objects_signal,       ///< observers of new_objects, changed_objects and removed_objects
+      pending_transactions_popped,  ///< push_block: undoing the pending transactions
+      block_push,                   ///< push_block: fork database, fork switch, application and storage of blocks
+      pending_transactions_restored ///< push_block: pushing the pending transactions again
+   };
+
+   constexpr size_t block_phase_count = size_t( block_phase::pending_transactions_restored ) + 1;
+
+   /// Duration statistics of one step of block application
+   struct block_phase_stats
+   {
+      /// Bucket @c i of the histogram counts the durations of less than 2^i microseconds which are not counted
+      /// in a previous bucket, the last bucket counts all longer durations
+      static constexpr size_t histogram_size = 24;
+
+      uint64_t         count = 0;
+      fc::microseconds total;
+      fc::microseconds max;
+      std::vector< uint64_t > histogram = std::vector< uint64_t >( histogram_size, 0 );
+
+      void record( const fc::microseconds& elapsed );
+   };
+
+   typedef std::array< block_phase_stats, block_phase_count > block_phase_stats_array;
+
+   /**
+    *  @brief Duration statistics of the evaluation of one type of operation
+    *
+    *  The durations of an operation which applies other operations, such as a proposal update, include the
+    *  durations of the operations it applies.
+    */
+   struct operation_timing_stats
+   {
+      block_phase_stats evaluate; ///< checks of the operation against the state, @ref generic_evaluator::evaluate
+      block_phase_stats apply;    ///< changes of the state, @ref generic_evaluator::apply
+   };
+
+   /// The name of the type of operation with tag @p which, without its namespace
+   std::string operation_type_name( int64_t which );
+
+   /// Log the operation types with the largest total duration, at most @p count of them
+   void log_operation_timing_stats( const std::vector< operation_timing_stats >& stats, size_t count );
+
+   /**
+    *  @brief Attributes the time elapsed since the previous lap to a step of block application
+    *
+    *  The durations are added to the node-wide statistics, and kept for the block at hand so that a slow block
+    *  can be traced. The first lap is measured from the construction of the clock.
+    */
+   class block_phase_clock
+   {
+      public:
+         explicit block_phase_clock( block_phase_stats_array& stats )
+            : _stats( stats ), _start( fc::time_point::now() ), _last( _start ) {}
+
+         void lap( block_phase phase )
+         {
+            const fc::time_point now = fc::time_point::now();
+            const fc::microseconds elapsed = now - _last;
+            _stats[ size_t( phase ) ].record( elapsed );
+            _elapsed[ size_t( phase ) ] += elapsed;
+            _last = now;
+         }
+
+         /// Log the duration of every step measured so far if their sum exceeds the threshold, unless it is zero
+         void trace_if_slow( const fc::microseconds& threshold, const char* what, uint32_t block_num )const;
+
+      private:
+         block_phase_stats_array& _stats;
+         fc::time_point           _start;
+         fc::time_point           _last;
+         std::array< fc::microseconds, block_phase_count > _elapsed;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT_ENUM( graphene::chain::block_phase,
+                 (header)
+                 (transactions)
+                 (global_state)
+                 (maintenance)
+                 (expired_transactions)
+                 (expired_proposals)
+                 (expired_orders)
+                 (expired_htlcs)
+                 (expired_feeds)
+                 (core_exchange_rates)
+                 (withdraw_permissions)
+                 (smooth_allocation)
+                 (witness_schedule)
+                 (applied_block_signal)
+                 (changed_objects_signal)
+                 (pending_transactions_popped)
+                 (block_push)
+                 (pending_transactions_restored)
+               )
+
+FC_REFLECT( graphene::chain::block_phase_stats, (count)(total)(max)(histogram) )
+FC_REFLECT( graphene::chain::operation_timing_stats, (evaluate)(apply) )
@@ -30,7 +30,14 @@
 
 #define GRAPHENE_MAX_NESTED_OBJECTS (200)
 
-#define GRAPHENE_CURRENT_DB_VERSION                          "20200910"
+/// Most expired limit orders cancelled by one block, the others wait for the next blocks
+#define GRAPHENE_MAX_EXPIRED_LIMIT_ORDERS_PER_BLOCK          1000
+/// Most expired proposals removed or executed by one block, the others wait for the next blocks
+#define GRAPHENE_MAX_EXPIRED_PROPOSALS_PER_BLOCK             100
+/// Most expired HTLCs refunded by one block, the others wait for the next blocks
+#define GRAPHENE_MAX_EXPIRED_HTLCS_PER_BLOCK                 1000
+
+#define GRAPHENE_CURRENT_DB_VERSION                          "20210301"
 
 #define GRAPHENE_RECENTLY_MISSED_COUNT_INCREMENT             4
 #define GRAPHENE_RECENTLY_MISSED_COUNT_DECREMENT             3
@@ -28,12 +28,15 @@
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/node_property_object.hpp>
 #include <graphene/chain/account_object.hpp>
+#include <graphene/chain/applied_operation_journal.hpp>
 #include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/block_phase_timer.hpp>
 #include <graphene/chain/property_object.hpp>
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/chain/impacted.hpp>
 
 #include <graphene/db/object_database.hpp>
 #include <graphene/db/object.hpp>
@@ -47,7 +50,6 @@
 namespace graphene { namespace chain {
    using graphene::db::abstract_object;
    using graphene::db::object;
-   class op_evaluator;
    class transaction_evaluation_state;
    class proposal_object;
    class operation_history_object;
@@ -58,6 +60,13 @@ namespace graphene { namespace chain {
    class limit_order_object;
    class collateral_bid_object;
    class call_order_object;
+   class vote_tally_index;
+   class verified_authority_cache;
+   class order_book_index;
+   class margin_call_index;
+   class required_approval_index;
+   class top_holders_index;
+   class balances_by_account_index;
 
    struct budget_record;
    enum class vesting_balance_type;
@@ -134,7 +143,7 @@ namespace graphene { namespace chain {
          block_id_type              get_block_id_for_num( uint32_t block_num )const;
          optional<signed_block>     fetch_block_by_id( const block_id_type& id )const;
          optional<signed_block>     fetch_block_by_number( uint32_t num )const;
-         const signed_transaction&  get_recent_transaction( const transaction_id_type& trx_id )const;
+         optional<signed_transaction> get_recent_transaction( const transaction_id_type& trx_id )const;
          std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
 
          /**
@@ -155,6 +164,14 @@ namespace graphene { namespace chain {
          ///@throws fc::exception if the proposed transaction fails to apply.
          processed_transaction push_proposal( const proposal_object& proposal );
 
+         /**
+          * Whether the approvals of @p proposal satisfy the authorities required by its transaction.
+          * A proposal which failed this check is not checked again until its approvals or the authorities of the
+          * accounts change.
+          */
+         bool is_proposal_authorized_to_execute( const proposal_object& proposal );
+         const required_approval_index& get_required_approval_index()const { return *_p_required_approval_idx; }
+
          signed_block generate_block(
             const fc::time_point_sec when,
             witness_id_type witness_id,
@@ -181,7 +198,7 @@ namespace graphene { namespace chain {
           */
          uint32_t  push_applied_operation( const operation& op );
          void      set_applied_operation_result( uint32_t op_id, const operation_result& r );
-         const vector<optional< operation_history_object > >& get_applied_operations()const;
+         const applied_operation_journal& get_applied_operations()const;
 
          string to_pretty_string( const asset& a )const;
 
@@ -203,20 +220,22 @@ namespace graphene { namespace chain {
 
          /**
           *  Emitted After a block has been applied and committed.  The callback
-          *  should not yield and should execute quickly.
+          *  should not yield and should execute quickly.  The impacted accounts
+          *  are only computed if a callback asks for them, and only once.
           */
-         fc::signal<void(const vector<object_id_type>&, const flat_set<account_id_type>&)> new_objects;
+         fc::signal<void(const vector<object_id_type>&, const impacted_accounts_cache&)> new_objects;
 
          /**
           *  Emitted After a block has been applied and committed.  The callback
-          *  should not yield and should execute quickly.
+          *  should not yield and should execute quickly.  The impacted accounts
+          *  are only computed if a callback asks for them, and only once.
           */
-         fc::signal<void(const vector<object_id_type>&, const flat_set<account_id_type>&)> changed_objects;
+         fc::signal<void(const vector<object_id_type>&, const impacted_accounts_cache&)> changed_objects;
 
          /** this signal is emitted any time an object is removed and contains a
           * pointer to the last value of every object that was removed.
           */
-         fc::signal<void(const vector<object_id_type>&, const vector<const object*>&, const flat_set<account_id_type>&)>  removed_objects;
+         fc::signal<void(const vector<object_id_type>&, const vector<const object*>&, const impacted_accounts_cache&)>  removed_objects;
 
          //////////////////// db_witness_schedule.cpp ////////////////////
 
@@ -292,8 +311,8 @@ namespace graphene { namespace chain {
          template<typename EvaluatorType>
          void register_evaluator()
          {
-            _operation_evaluators[
-               operation::tag<typename EvaluatorType::operation_type>::value].reset( new op_evaluator_impl<EvaluatorType>() );
+            _operation_evaluators[ operation::tag<typename EvaluatorType::operation_type>::value ]
+                  = &evaluate_operation<EvaluatorType>;
          }
 
          //////////////////// db_balance.cpp ////////////////////
@@ -361,7 +380,32 @@ namespace graphene { namespace chain {
          /// @{ @group Market Helpers
          void globally_settle_asset( const asset_object& bitasset, const price& settle_price );
          void cancel_settle_order(const force_settlement_object& order, bool create_virtual_op = true);
-         void cancel_limit_order(const limit_order_object& order, bool create_virtual_op = true, bool skip_cancel_fee = false);
+         /// Refunds of several cancelled limit orders, summed to be paid once per account and asset
+         struct limit_order_refunds
+         {
+            flat_map< std::pair<account_id_type, asset_id_type>, share_type > balances;
+            flat_map< account_id_type, share_type >                           core_in_orders;
+            flat_map< asset_id_type, share_type >                             fee_pools;
+
+            void add_balance( account_id_type account, const asset& amount );
+         };
+         /// Cancel a limit order, paying its refunds now, or adding them to @p refunds when it is not null
+         void cancel_limit_order(const limit_order_object& order, bool create_virtual_op = true, bool skip_cancel_fee = false,
+                                 limit_order_refunds* refunds = nullptr);
+         /**
+          * @brief Cancel the expired limit orders, earliest expiration first, at most @p max_count of them
+          * @return the number of cancelled orders
+          *
+          * The refunds are paid once per account and asset after all the orders are cancelled.
+          */
+         uint32_t cancel_expired_limit_orders( uint32_t max_count );
+         /**
+          * @brief After HARDFORK_EXPIRED_ORDER_BATCH_TIME, cancel @p order instead of matching it if it expired
+          * @return whether the order was cancelled
+          *
+          * The expired orders which the bounded batches did not cancel yet stay on the book, they must not be filled.
+          */
+         bool cancel_limit_order_if_expired( const limit_order_object& order );
          void revive_bitasset( const asset_object& bitasset );
          void cancel_bid(const collateral_bid_object& bid, bool create_virtual_op = true);
          void execute_bid( const collateral_bid_object& bid, share_type debt_covered, share_type collateral_from_fund, const price_feed& current_feed );
@@ -440,6 +484,12 @@ namespace graphene { namespace chain {
           */
          processed_transaction validate_transaction( const signed_transaction& trx );
 
+         /**
+          *  Verify that the signatures of a transaction satisfy the authorities it requires under the current state.
+          *  Verifications which succeeded before for the same signers and the same authorities are not repeated.
+          */
+         void verify_transaction_authority( const signed_transaction& trx )const;
+
 
          /** when popping a block, the transactions that were removed get cached here so they
           * can be reapplied at the proper time */
@@ -449,6 +499,22 @@ namespace graphene { namespace chain {
           * @}
           */
 
+         /// Duration statistics of the steps of block application since the node started
+         const block_phase_stats_array& get_block_phase_stats()const { return _block_phase_stats; }
+
+         /// Log the duration of every step of a block whose push or application takes longer, zero to disable
+         void set_slow_block_threshold( const fc::microseconds& threshold ) { _slow_block_threshold = threshold; }
+
+         /// Start measuring the evaluation of every type of operation, or stop and discard the measures
+         void set_operation_timing_enabled( bool enabled );
+
+         /// Duration statistics of the evaluation of operations, indexed by operation tag, empty unless enabled
+         const vector<operation_timing_stats>& get_operation_timing_stats()const { return _operation_timing_stats; }
+
+         /// The statistics to record the evaluation of an operation with tag @p which in, null unless enabled
+         operation_timing_stats* operation_timing_stats_for( int which )
+         { return _operation_timing_stats.empty() ? nullptr : &_operation_timing_stats[ which ]; }
+
          /// Enable or disable tracking of votes of standby witnesses and committee members
          inline void enable_standby_votes_tracking(bool enable)  { _track_standby_votes = enable; }
 
@@ -484,7 +550,8 @@ namespace graphene { namespace chain {
 
       private:
          optional<undo_database::session>       _pending_tx_session;
-         vector< unique_ptr<op_evaluator> >     _operation_evaluators;
+         /// Evaluation function of each operation type, indexed by operation tag, null if none is registered
+         vector< operation_evaluation_function > _operation_evaluators;
 
          template<class Index>
          vector<std::reference_wrapper<const typename Index::object_type>> sort_votable_objects(size_t count)const;
@@ -549,11 +616,12 @@ namespace graphene { namespace chain {
          void update_active_witnesses();
          void update_active_committee_members();
          void update_worker_votes();
+         void update_top_n_authorities();
          void process_bids( const asset_bitasset_data_object& bad );
          void process_bitassets();
 
          template<class Type>
-         void perform_account_maintenance( Type tally_helper );
+         void perform_account_maintenance( Type& tally_helper );
          ///@}
          ///@}
 
@@ -577,8 +645,10 @@ namespace graphene { namespace chain {
           * order they occur and is cleared after the applied_block signal is
           * emited.
           */
-         vector<optional<operation_history_object> >  _applied_ops;
+         applied_operation_journal                    _applied_ops;
 
+         /// Whether the transactions being applied are part of a block, rather than pending or popped ones
+         bool                              _applying_block       = false;
          uint32_t                          _current_block_num    = 0;
          uint16_t                          _current_trx_in_block = 0;
          uint16_t                          _current_op_in_trx    = 0;
@@ -609,6 +679,11 @@ namespace graphene { namespace chain {
          // Counts nested proposal updates
          uint32_t                           _push_proposal_nesting_depth = 0;
 
+         /// Duration statistics of the steps of block application, see @ref block_phase
+         block_phase_stats_array           _block_phase_stats;
+         fc::microseconds                  _slow_block_threshold;
+         vector<operation_timing_stats>    _operation_timing_stats;
+
          /// Tracks assets affected by bitshares-core issue #453 before hard fork #615 in one block
          flat_set<asset_id_type>           _issue_453_affected_assets;
 
@@ -621,6 +696,27 @@ namespace graphene { namespace chain {
          const chain_property_object*           _p_chain_property_obj      = nullptr;
          const witness_schedule_object*         _p_witness_schedule_obj    = nullptr;
          ///@}
+
+         /// Running tally of the maintenance votes, owned by the account index
+         vote_tally_index*                      _p_vote_tally_idx          = nullptr;
+
+         /// Successful verifications of transaction signatures, owned by the account index
+         verified_authority_cache*              _p_authority_cache         = nullptr;
+
+         /// Price levels of the limit orders, owned by the limit order index
+         order_book_index*                      _p_order_book_idx          = nullptr;
+
+         /// Debt positions by collateralization, owned by the call order index
+         margin_call_index*                     _p_margin_call_idx         = nullptr;
+
+         /// Approvals and failed authorization checks of the proposals, owned by the proposal index
+         required_approval_index*               _p_required_approval_idx   = nullptr;
+
+         /// Largest holders of the assets of the top holders special authorities, owned by the balance index
+         top_holders_index*                     _p_top_holders_idx         = nullptr;
+
+         /// Balances of every account, owned by the balance index
+         balances_by_account_index*             _p_balances_by_account_idx = nullptr;
    };
 
    namespace detail
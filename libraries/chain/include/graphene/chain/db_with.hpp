@@ -59,6 +59,27 @@ struct skip_flags_restorer
    uint32_t _old_skip_flags;      // initialized in ctor
 };
 
+/**
+ * Class used by database::_apply_block to tell the transactions it
+ * applies that they are part of the block, until the block is applied
+ * or fails to apply.
+ */
+struct applying_block_flag
+{
+   explicit applying_block_flag( bool& applying_block )
+      : _applying_block( applying_block )
+   {
+      _applying_block = true;
+   }
+
+   ~applying_block_flag()
+   {
+      _applying_block = false;
+   }
+
+   bool& _applying_block;
+};
+
 /**
  * Class used to help the without_pending_transactions
  * implementation.
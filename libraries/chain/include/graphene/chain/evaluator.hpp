@@ -121,23 +121,17 @@ namespace graphene { namespace chain {
       transaction_evaluation_state*    trx_state;
    };
 
-   class op_evaluator
-   {
-   public:
-      virtual ~op_evaluator(){}
-      virtual operation_result evaluate(transaction_evaluation_state& eval_state, const operation& op, bool apply) = 0;
-   };
+   /// Evaluates and optionally applies an operation, see @ref evaluate_operation
+   typedef operation_result (*operation_evaluation_function)( transaction_evaluation_state& eval_state,
+                                                              const operation& op, bool apply );
 
+   /// Evaluates and optionally applies an operation with an evaluator of type T constructed on the stack
    template<typename T>
-   class op_evaluator_impl : public op_evaluator
+   operation_result evaluate_operation( transaction_evaluation_state& eval_state, const operation& op, bool apply )
    {
-   public:
-      virtual operation_result evaluate(transaction_evaluation_state& eval_state, const operation& op, bool apply = true) override
-      {
-         T eval;
-         return eval.start_evaluate(eval_state, op, apply);
-      }
-   };
+      T eval;
+      return eval.start_evaluate(eval_state, op, apply);
+   }
 
    template<typename DerivedEvaluator>
    class evaluator : public generic_evaluator
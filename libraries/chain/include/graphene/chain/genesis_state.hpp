@@ -126,6 +126,16 @@ struct genesis_state_type {
    chain_id_type compute_chain_id() const;
 };
 
+/**
+ * Convert a parsed genesis file to a genesis state.
+ *
+ * The initial accounts, balances and vesting balances, which hold most of the data of a large genesis, are converted
+ * in chunks on several threads, into vectors allocated to their final size. Their keys and addresses are decoded
+ * from their string representation during the conversion. The result is the same as <tt>var.as<genesis_state_type>(
+ * max_depth )</tt>.
+ */
+genesis_state_type load_genesis_state( const fc::variant& var, uint32_t max_depth );
+
 } } // namespace graphene::chain
 
 FC_REFLECT_TYPENAME( graphene::chain::genesis_state_type::initial_account_type )
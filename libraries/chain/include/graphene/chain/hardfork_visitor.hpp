@@ -63,6 +63,12 @@ struct hardfork_visitor {
    template<typename Op>
    std::enable_if_t<TL::contains<liquidity_pool_ops, Op>(), bool>
    visit() { return HARDFORK_LIQUIDITY_POOL_PASSED(now); }
+   template<typename Op>
+   std::enable_if_t<std::is_same<Op, asset_price_publish_batch_operation>::value, bool>
+   visit() { return HARDFORK_ASSET_PRICE_BATCH_PASSED(now); }
+   template<typename Op>
+   std::enable_if_t<std::is_same<Op, liquidity_pool_route_exchange_operation>::value, bool>
+   visit() { return HARDFORK_LIQUIDITY_POOL_ROUTE_PASSED(now); }
    /// @}
 
    /// typelist::runtime::dispatch adaptor
@@ -28,6 +28,8 @@
 #include <graphene/protocol/transaction.hpp>
 #include <graphene/protocol/types.hpp>
 
+namespace graphene { namespace db { class object; } }
+
 namespace graphene { namespace chain {
 
 void operation_get_impacted_accounts(
@@ -39,4 +41,27 @@ void transaction_get_impacted_accounts(
    fc::flat_set<graphene::chain::account_id_type>& result
    );
 
+/**
+ *  @brief The accounts impacted by a set of objects, computed the first time they are requested.
+ *
+ *  The database passes one to every observer of its object signals, so that the accounts are not computed when no
+ *  observer looks at them, and are computed once however many observers do. It refers to the objects, which must
+ *  outlive it.
+ */
+class impacted_accounts_cache
+{
+   public:
+      explicit impacted_accounts_cache( const std::vector<const graphene::db::object*>& objects )
+      : _objects( objects ) {}
+
+      /// The accounts impacted by the objects, computed by the first call
+      const fc::flat_set<graphene::chain::account_id_type>& get()const;
+
+      bool is_computed()const { return _accounts.valid(); }
+
+   private:
+      const std::vector<const graphene::db::object*>&                        _objects;
+      mutable fc::optional< fc::flat_set<graphene::chain::account_id_type> > _accounts;
+};
+
 } } // graphene::app
\ No newline at end of file
@@ -28,10 +28,52 @@
 
 namespace graphene { namespace chain {
 
+   class account_object;
    class asset_object;
    class asset_dynamic_data_object;
+   class database;
    class liquidity_pool_object;
 
+   /// The amounts moved by selling an amount of one asset of a liquidity pool for the other one
+   struct liquidity_pool_exchange_amounts
+   {
+      asset pool_receives;     ///< The amount sold, less the maker market fee
+      asset pool_pays;         ///< The amount paid by the pool, before the taker market fee
+      asset account_receives;  ///< The amount paid by the pool, less the taker market fee
+      asset maker_market_fee;  ///< Market fee of the asset sold
+      asset taker_market_fee;  ///< Market fee of the asset received
+      asset pool_taker_fee;    ///< Taker fee of the pool, kept in the pool
+   };
+
+   /**
+    * @brief Calculate an exchange with a liquidity pool, with 128-bit integers
+    * @param pool The pool, which must have been initialized
+    * @param sell_asset The asset sold, one of the assets of the pool
+    * @param receive_asset The other asset of the pool
+    * @param amount_to_sell The amount sold
+    *
+    * Throws if the exchange is not possible, like when the fees are too high.
+    */
+   liquidity_pool_exchange_amounts calculate_liquidity_pool_exchange( const database& d,
+                                                                      const liquidity_pool_object& pool,
+                                                                      const asset_object& sell_asset,
+                                                                      const asset_object& receive_asset,
+                                                                      const asset& amount_to_sell );
+
+   /**
+    * @brief Apply an exchange calculated by @ref calculate_liquidity_pool_exchange to the pool
+    * @param account The account exchanging, which pays the taker market fee
+    *
+    * Pays the market fees and updates the balances of the pool, but not the balances of the account.
+    */
+   void apply_liquidity_pool_exchange( database& d,
+                                       const account_object& account,
+                                       const liquidity_pool_object& pool,
+                                       const asset_object& sell_asset,
+                                       const asset_object& receive_asset,
+                                       const asset& amount_to_sell,
+                                       const liquidity_pool_exchange_amounts& amounts );
+
    class liquidity_pool_create_evaluator : public evaluator<liquidity_pool_create_evaluator>
    {
       public:
@@ -105,4 +147,24 @@ namespace graphene { namespace chain {
          asset _pool_taker_fee;
    };
 
+   class liquidity_pool_route_exchange_evaluator : public evaluator<liquidity_pool_route_exchange_evaluator>
+   {
+      public:
+         typedef liquidity_pool_route_exchange_operation operation_type;
+
+         void_result do_evaluate( const liquidity_pool_route_exchange_operation& op );
+         generic_exchange_operation_result do_apply( const liquidity_pool_route_exchange_operation& op );
+
+         /// An exchange with one of the pools
+         struct hop
+         {
+            const liquidity_pool_object*     pool = nullptr;
+            const asset_object*              sell_asset = nullptr;
+            const asset_object*              receive_asset = nullptr;
+            asset                            amount_to_sell;
+            liquidity_pool_exchange_amounts  amounts;
+         };
+         vector<hop> _hops;
+   };
+
 } } // graphene::chain
@@ -0,0 +1,56 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/db/generic_index.hpp>
+
+#include <map>
+#include <set>
+
+namespace graphene { namespace chain {
+   class call_order_object;
+   class asset_bitasset_data_object;
+
+   /**
+    *  @brief This secondary index keeps the debt positions of every market issued asset by collateralization.
+    *
+    *  The positions of an asset are sorted like the by_collateral index of the call orders, least collateralized
+    *  first, so that the position a margin call or a black swan starts from is found without searching the call
+    *  orders of all the assets, and whether any position of an asset can be called is answered by comparing that
+    *  position with the maintenance collateralization of the current feed.
+    *
+    *  It is attached to the call order index, and follows every change of the positions, including when it is undone.
+    */
+   class margin_call_index : public secondary_index
+   {
+      public:
+         struct by_collateralization
+         {
+            bool operator()( const call_order_object* a, const call_order_object* b )const;
+         };
+         typedef std::set< const call_order_object*, by_collateralization > position_set;
+
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// The positions in debt of @p debt_asset, least collateralized first, or nullptr if there are none
+         const position_set* get_positions( asset_id_type debt_asset )const;
+
+         /// The least collateralized position in debt of @p debt_asset, or nullptr if there are none
+         const call_order_object* get_least_collateralized( asset_id_type debt_asset )const;
+
+         /// Whether the least collateralized position of @p bitasset is not above its maintenance collateralization
+         bool has_callable_position( const asset_bitasset_data_object& bitasset )const;
+
+      private:
+         void add( const call_order_object& position );
+         void remove( const call_order_object& position );
+
+         std::map< asset_id_type, position_set > _positions;
+   };
+
+} } // graphene::chain
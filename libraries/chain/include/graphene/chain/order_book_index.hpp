@@ -0,0 +1,65 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/db/generic_index.hpp>
+#include <graphene/protocol/asset.hpp>
+
+#include <map>
+#include <set>
+
+namespace graphene { namespace chain {
+   class limit_order_object;
+
+   /**
+    *  @brief This secondary index aggregates the limit orders of every market into price levels.
+    *
+    *  A level holds the orders selling one asset for another at the same price, oldest first, which is the order in
+    *  which they are matched, and the total amount they sell. The levels of both sides of every market are sorted
+    *  like the by_price index of the limit orders, best price first, so that the best price of a side and the volume
+    *  available at each price are found without visiting the orders.
+    *
+    *  It is attached to the limit order index, and follows every change of the orders, including when it is undone.
+    */
+   class order_book_index : public secondary_index
+   {
+      public:
+         struct price_level
+         {
+            /// Total amount for sale at this price, in the asset sold
+            share_type                    for_sale;
+            /// The orders at this price, oldest first
+            std::set<limit_order_id_type> orders;
+         };
+         typedef std::map< price, price_level, std::greater<price> > level_map;
+         typedef level_map::const_iterator                             level_iterator;
+
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// The levels of the orders selling @p sell for @p receive, best price first
+         std::pair<level_iterator, level_iterator> get_levels( asset_id_type sell, asset_id_type receive )const;
+
+         /// Whether no other order on the side of @p order has a better price, or the same price and is older
+         bool is_first_in_line( const limit_order_object& order )const;
+
+         /// Whether the best order of the opposite side of an order selling at @p sell_price can be matched with it
+         bool is_crossed_by( const price& sell_price )const;
+
+         size_t get_level_count()const { return _levels.size(); }
+
+      private:
+         void add( const price& sell_price, limit_order_id_type order, share_type for_sale );
+         void subtract( const price& sell_price, limit_order_id_type order, share_type for_sale );
+
+         level_map                                 _levels;
+
+         /// Price and amount for sale of the order being modified
+         optional< std::pair<price, share_type> >  _order_being_modified;
+   };
+
+} } // graphene::chain
@@ -31,6 +31,7 @@
 
 namespace graphene { namespace chain {
    class database;
+   class verified_authority_cache;
 
 /**
  *  @brief tracks the approval of a partially approved transaction 
@@ -66,24 +67,59 @@ class proposal_object : public abstract_object<proposal_object>
  *
  *  This is a secondary index on the proposal_index
  *
+ *  When it is given the authority cache of the database, it also remembers the proposals which were found not to
+ *  be authorized to execute, so that they are not checked again until their approvals, the owner or active
+ *  authority of any account, the set of accounts, or the verification parameters change.
+ *
  *  @note the set of required approvals is constant
  */
 class required_approval_index : public secondary_index
 {
    public:
+      explicit required_approval_index( const verified_authority_cache* authorities = nullptr )
+         : _authorities( authorities ) {}
+
       virtual void object_inserted( const object& obj ) override;
       virtual void object_removed( const object& obj ) override;
       virtual void about_to_modify( const object& before ) override;
       virtual void object_modified( const object& after  ) override;
 
+      /// Whether @p p is authorized to execute, without checking it again if the same check failed before
+      bool is_authorized_to_execute( database& db, const proposal_object& p );
+
+      uint64_t get_checks()const { return _checks; }
+      uint64_t get_skipped_checks()const { return _skipped_checks; }
+
       map<account_id_type, set<proposal_id_type> > _account_to_proposals;
 
    private:
+      /// What a failed authorization check depended on, besides the approvals of the proposal
+      struct authorization_check
+      {
+         uint64_t authority_revision = 0;
+         uint32_t max_authority_depth = 0;
+         bool     allow_non_immediate_owner = false;
+
+         bool operator==( const authorization_check& other )const
+         {
+            return authority_revision == other.authority_revision
+                && max_authority_depth == other.max_authority_depth
+                && allow_non_immediate_owner == other.allow_non_immediate_owner;
+         }
+      };
+
       void remove( account_id_type a, proposal_id_type p );
       void insert_or_remove_delta( proposal_id_type p, const flat_set<account_id_type>& before,
                                    const flat_set<account_id_type>& after );
       flat_set<account_id_type> available_active_before_modify;
       flat_set<account_id_type> available_owner_before_modify;
+      flat_set<public_key_type> available_key_before_modify;
+
+      const verified_authority_cache*                   _authorities = nullptr;
+      /// The proposals whose last authorization check failed, forgotten when their approvals change
+      map<proposal_id_type, authorization_check>        _unauthorized;
+      uint64_t _checks = 0;
+      uint64_t _skipped_checks = 0;
 };
 
 struct by_expiration{};
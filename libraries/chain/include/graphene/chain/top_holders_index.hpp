@@ -0,0 +1,73 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/db/generic_index.hpp>
+
+#include <map>
+#include <set>
+
+namespace graphene { namespace chain {
+   class database;
+
+   /**
+    *  @brief This secondary index keeps the largest holders of the assets used by top holders special authorities.
+    *
+    *  For every tracked asset it keeps, largest balance first, then lowest account ID, the accounts with
+    *  the largest positive balances, up to the number needed by the special authorities of the asset. The list
+    *  follows every change of the balances, including when it is undone, so that maintenance does not have to look
+    *  the holders up again.
+    *
+    *  When a holder of a full list goes below the smallest balance of the list, a holder which is not listed may be
+    *  larger, so the list is marked as incomplete and selected again from the balances of the asset the next time it
+    *  is read.
+    */
+   class top_holders_index : public secondary_index
+   {
+      public:
+         struct holder_compare
+         {
+            bool operator()( const std::pair<share_type, account_id_type>& a,
+                             const std::pair<share_type, account_id_type>& b )const
+            {
+               return a.first > b.first || ( a.first == b.first && a.second < b.second );
+            }
+         };
+         /// Balances and owners of the largest holders, largest first
+         typedef std::set< std::pair<share_type, account_id_type>, holder_compare > holder_set;
+
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// Track exactly the given assets, keeping the given number of largest holders of each
+         void track( const flat_map<asset_id_type, uint16_t>& holder_counts );
+
+         /// The largest holders of a tracked asset, looked up again from the balances if the list is incomplete
+         const holder_set& get_top_holders( const database& db, asset_id_type asset );
+
+         /// Number of times the holders of an asset were looked up from the balances
+         uint64_t get_lookups()const { return _lookups; }
+
+      private:
+         struct tracked_asset
+         {
+            uint16_t   capacity = 0;
+            bool       complete = false;
+            holder_set holders;
+         };
+
+         void update( asset_id_type asset, account_id_type owner, share_type before, share_type after );
+
+         std::map< asset_id_type, tracked_asset > _assets;
+
+         /// Balance of the object being modified
+         optional< share_type >                   _balance_being_modified;
+
+         uint64_t _lookups = 0;
+   };
+
+} } // graphene::chain
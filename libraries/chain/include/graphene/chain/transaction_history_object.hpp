@@ -40,6 +40,9 @@ namespace graphene { namespace chain {
     * The purpose of this object is to enable the detection of duplicate transactions. When a transaction is included
     * in a block a transaction_history_object is added. At the end of block processing all transaction_history_objects that
     * have expired can be removed from the index.
+    *
+    * Only the ID and the expiration of the transaction are kept. The transaction itself can be found in the block
+    * it was included in, or among the pending transactions.
     */
    class transaction_history_object : public abstract_object<transaction_history_object>
    {
@@ -47,10 +50,14 @@ namespace graphene { namespace chain {
          static const uint8_t space_id = implementation_ids;
          static const uint8_t type_id  = impl_transaction_history_object_type;
 
-         signed_transaction  trx;
          transaction_id_type trx_id;
+         time_point_sec      expiration;
+         /// The block the transaction was included in, 0 if it is pending
+         uint32_t            block_num = 0;
+         /// The position of the transaction in its block
+         uint16_t            trx_in_block = 0;
 
-         time_point_sec get_expiration()const { return trx.expiration; }
+         time_point_sec get_expiration()const { return expiration; }
    };
 
    struct by_expiration;
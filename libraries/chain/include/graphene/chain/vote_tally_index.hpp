@@ -0,0 +1,111 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/db/generic_index.hpp>
+#include <graphene/protocol/account.hpp>
+
+#include <unordered_set>
+
+namespace graphene { namespace chain {
+   class database;
+   class global_property_object;
+
+   /**
+    *  @brief This secondary index keeps a running tally of the maintenance votes between maintenance intervals.
+    *
+    *  The tally is the sum, over every opinion account, of the stake voting through that account applied to the
+    *  current options of the account. Changes of the options are applied as soon as they happen, including when they
+    *  are undone. Changes of the stakes are only collected, and applied by @ref update at the next maintenance, so
+    *  that maintenance only visits the accounts whose stake or voting account changed since the previous one.
+    *
+    *  It is attached to the account index. The account statistics and vesting balance indexes report stake changes
+    *  through a @ref vote_stake_watcher.
+    *
+    *  The tally lives outside of the object database. It is invalidated whenever it can not follow a change, and
+    *  rebuilt from scratch at the next maintenance.
+    */
+   class vote_tally_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /** Record that the voting stake of an account may have changed */
+         void stake_changed( account_id_type account );
+
+         /** Whether the tally can be updated incrementally under the given global properties */
+         bool is_valid_for( const global_property_object& gpo )const;
+
+         /** Recompute the tally from all voting accounts */
+         void rebuild( const database& db );
+
+         /** Apply the stake changes collected since the last maintenance, or rebuild if that is not possible */
+         void update( const database& db );
+
+         const vector<uint64_t>& get_vote_tally()const { return _vote_tally; }
+         const vector<uint64_t>& get_witness_count_histogram()const { return _witness_count_histogram; }
+         const vector<uint64_t>& get_committee_count_histogram()const { return _committee_count_histogram; }
+         uint64_t get_total_voting_stake()const { return _total_voting_stake; }
+
+      private:
+         /// The stake an account voted with at the last maintenance, and the stake voting through it
+         struct stake_record
+         {
+            uint64_t        stake = 0;
+            account_id_type opinion_account;
+            uint64_t        opinion_stake = 0;
+         };
+
+         stake_record& get_record( account_id_type account );
+         void apply_stake( account_id_type opinion_account, const account_options& opinions, uint64_t stake,
+                           bool add );
+         void refresh( const database& db, account_id_type account );
+
+         bool                       _valid = false;
+         uint32_t                   _vote_id_count = 0;
+         uint16_t                   _maximum_witness_count = 0;
+         uint16_t                   _maximum_committee_count = 0;
+
+         vector<stake_record>       _records;
+         std::unordered_set<uint64_t> _changed_accounts;
+
+         vector<uint64_t>           _vote_tally;
+         vector<uint64_t>           _witness_count_histogram;
+         vector<uint64_t>           _committee_count_histogram;
+         uint64_t                   _total_voting_stake = 0;
+
+         /// Options of the opinion account being modified, if stake votes through it
+         optional<account_options>  _options_being_modified;
+   };
+
+   /**
+    *  @brief Reports to a @ref vote_tally_index the owners of the objects of another index that are changed.
+    *
+    *  @tparam ObjectType an object type with an @c owner account, e.g. account statistics or vesting balances
+    */
+   template<typename ObjectType>
+   class vote_stake_watcher : public secondary_index
+   {
+      public:
+         explicit vote_stake_watcher( vote_tally_index* tally ) : _tally( tally ) {}
+
+         virtual void object_inserted( const object& obj ) override { changed( obj ); }
+         virtual void object_removed( const object& obj ) override { changed( obj ); }
+         virtual void object_modified( const object& after  ) override { changed( after ); }
+
+      private:
+         void changed( const object& obj )
+         {
+            assert( dynamic_cast<const ObjectType*>(&obj) ); // for debug only
+            _tally->stake_changed( static_cast<const ObjectType&>(obj).owner );
+         }
+
+         vote_tally_index* _tally;
+   };
+
+} } // graphene::chain
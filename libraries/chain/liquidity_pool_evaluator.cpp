@@ -35,6 +35,84 @@
 
 namespace graphene { namespace chain {
 
+liquidity_pool_exchange_amounts calculate_liquidity_pool_exchange( const database& d,
+                                                                   const liquidity_pool_object& pool,
+                                                                   const asset_object& sell_asset,
+                                                                   const asset_object& receive_asset,
+                                                                   const asset& amount_to_sell )
+{
+   liquidity_pool_exchange_amounts result;
+
+   result.maker_market_fee = d.calculate_market_fee( sell_asset, amount_to_sell, true );
+   FC_ASSERT( result.maker_market_fee < amount_to_sell,
+              "Aborting since the maker market fee of the selling asset is too high" );
+   result.pool_receives = amount_to_sell - result.maker_market_fee;
+
+   fc::uint128_t delta;
+   if( amount_to_sell.asset_id == pool.asset_a )
+   {
+      share_type new_balance_a = pool.balance_a + result.pool_receives.amount;
+      // round up
+      fc::uint128_t new_balance_b = ( pool.virtual_value + new_balance_a.value - 1 ) / new_balance_a.value;
+      FC_ASSERT( new_balance_b <= pool.balance_b, "Internal error" );
+      delta = fc::uint128_t( pool.balance_b.value ) - new_balance_b;
+   }
+   else
+   {
+      share_type new_balance_b = pool.balance_b + result.pool_receives.amount;
+      // round up
+      fc::uint128_t new_balance_a = ( pool.virtual_value + new_balance_b.value - 1 ) / new_balance_b.value;
+      FC_ASSERT( new_balance_a <= pool.balance_a, "Internal error" );
+      delta = fc::uint128_t( pool.balance_a.value ) - new_balance_a;
+   }
+
+   fc::uint128_t pool_taker_fee = delta * pool.taker_fee_percent / GRAPHENE_100_PERCENT;
+   FC_ASSERT( pool_taker_fee <= delta, "Taker fee percent of the pool is too high" );
+
+   result.pool_pays = asset( static_cast<int64_t>( delta - pool_taker_fee ), receive_asset.get_id() );
+
+   result.taker_market_fee = d.calculate_market_fee( receive_asset, result.pool_pays, false );
+   FC_ASSERT( result.taker_market_fee <= result.pool_pays,
+              "Market fee should not be greater than the amount to receive" );
+   result.account_receives = result.pool_pays - result.taker_market_fee;
+
+   result.pool_taker_fee = asset( static_cast<int64_t>( pool_taker_fee ), receive_asset.get_id() );
+
+   return result;
+}
+
+void apply_liquidity_pool_exchange( database& d,
+                                    const account_object& account,
+                                    const liquidity_pool_object& pool,
+                                    const asset_object& sell_asset,
+                                    const asset_object& receive_asset,
+                                    const asset& amount_to_sell,
+                                    const liquidity_pool_exchange_amounts& amounts )
+{
+   // TODO whose registrar and referrer should receive the shared maker market fee?
+   d.pay_market_fees( &pool.share_asset(d).issuer(d), sell_asset, amount_to_sell, true, amounts.maker_market_fee );
+   d.pay_market_fees( &account, receive_asset, amounts.pool_pays, false, amounts.taker_market_fee );
+
+   const auto old_virtual_value = pool.virtual_value;
+   const bool sells_a = ( amount_to_sell.asset_id == pool.asset_a );
+   d.modify( pool, [&amounts,sells_a]( liquidity_pool_object& lpo ){
+      if( sells_a )
+      {
+         lpo.balance_a += amounts.pool_receives.amount;
+         lpo.balance_b -= amounts.pool_pays.amount;
+      }
+      else
+      {
+         lpo.balance_b += amounts.pool_receives.amount;
+         lpo.balance_a -= amounts.pool_pays.amount;
+      }
+      lpo.update_virtual_value();
+   });
+
+   FC_ASSERT( pool.balance_a > 0 && pool.balance_b > 0, "Internal error" );
+   FC_ASSERT( pool.virtual_value >= old_virtual_value, "Internal error" );
+}
+
 void_result liquidity_pool_create_evaluator::do_evaluate(const liquidity_pool_create_operation& op)
 { try {
    const database& d = db();
@@ -323,45 +401,20 @@ void_result liquidity_pool_exchange_evaluator::do_evaluate(const liquidity_pool_
               "The account is unauthorized by asset B" );
 
    _pool_receives_asset = ( op.amount_to_sell.asset_id == _pool->asset_a ? &asset_obj_a : &asset_obj_b );
-
-   _maker_market_fee = d.calculate_market_fee( *_pool_receives_asset, op.amount_to_sell, true );
-   FC_ASSERT( _maker_market_fee < op.amount_to_sell,
-              "Aborting since the maker market fee of the selling asset is too high" );
-   _pool_receives = op.amount_to_sell - _maker_market_fee;
-
-   fc::uint128_t delta;
-   if( op.amount_to_sell.asset_id == _pool->asset_a )
-   {
-      share_type new_balance_a = _pool->balance_a + _pool_receives.amount;
-      // round up
-      fc::uint128_t new_balance_b = ( _pool->virtual_value + new_balance_a.value - 1 ) / new_balance_a.value;
-      FC_ASSERT( new_balance_b <= _pool->balance_b, "Internal error" );
-      delta = fc::uint128_t( _pool->balance_b.value ) - new_balance_b;
-      _pool_pays_asset = &asset_obj_b;
-   }
-   else
-   {
-      share_type new_balance_b = _pool->balance_b + _pool_receives.amount;
-      // round up
-      fc::uint128_t new_balance_a = ( _pool->virtual_value + new_balance_b.value - 1 ) / new_balance_b.value;
-      FC_ASSERT( new_balance_a <= _pool->balance_a, "Internal error" );
-      delta = fc::uint128_t( _pool->balance_a.value ) - new_balance_a;
-      _pool_pays_asset = &asset_obj_a;
-   }
-
-   fc::uint128_t pool_taker_fee = delta * _pool->taker_fee_percent / GRAPHENE_100_PERCENT;
-   FC_ASSERT( pool_taker_fee <= delta, "Taker fee percent of the pool is too high" );
-
-   _pool_pays = asset( static_cast<int64_t>( delta - pool_taker_fee ), op.min_to_receive.asset_id );
-
-   _taker_market_fee = d.calculate_market_fee( *_pool_pays_asset, _pool_pays, false );
-   FC_ASSERT( _taker_market_fee <= _pool_pays, "Market fee should not be greater than the amount to receive" );
-   _account_receives = _pool_pays - _taker_market_fee;
+   _pool_pays_asset = ( op.amount_to_sell.asset_id == _pool->asset_a ? &asset_obj_b : &asset_obj_a );
+
+   const liquidity_pool_exchange_amounts amounts = calculate_liquidity_pool_exchange( d, *_pool, *_pool_receives_asset,
+                                                                                      *_pool_pays_asset,
+                                                                                      op.amount_to_sell );
+   _pool_receives = amounts.pool_receives;
+   _pool_pays = amounts.pool_pays;
+   _account_receives = amounts.account_receives;
+   _maker_market_fee = amounts.maker_market_fee;
+   _taker_market_fee = amounts.taker_market_fee;
+   _pool_taker_fee = amounts.pool_taker_fee;
 
    FC_ASSERT( _account_receives.amount >= op.min_to_receive.amount, "Unable to exchange at expected price" );
 
-   _pool_taker_fee = asset( static_cast<int64_t>( pool_taker_fee ), op.min_to_receive.asset_id );
-
    return void_result();
 } FC_CAPTURE_AND_RETHROW( (op) ) }
 
@@ -374,37 +427,94 @@ generic_exchange_operation_result liquidity_pool_exchange_evaluator::do_apply(
    d.adjust_balance( op.account, -op.amount_to_sell );
    d.adjust_balance( op.account, _account_receives );
 
-   // TODO whose registrar and referrer should receive the shared maker market fee?
-   d.pay_market_fees( &_pool->share_asset(d).issuer(d), *_pool_receives_asset, op.amount_to_sell, true,
-                      _maker_market_fee );
-   d.pay_market_fees( fee_paying_account, *_pool_pays_asset, _pool_pays, false, _taker_market_fee );
+   liquidity_pool_exchange_amounts amounts;
+   amounts.pool_receives = _pool_receives;
+   amounts.pool_pays = _pool_pays;
+   amounts.account_receives = _account_receives;
+   amounts.maker_market_fee = _maker_market_fee;
+   amounts.taker_market_fee = _taker_market_fee;
+   amounts.pool_taker_fee = _pool_taker_fee;
+   apply_liquidity_pool_exchange( d, *fee_paying_account, *_pool, *_pool_receives_asset, *_pool_pays_asset,
+                                  op.amount_to_sell, amounts );
+
+   result.paid.emplace_back( op.amount_to_sell );
+   result.received.emplace_back( _account_receives );
+   result.fees.emplace_back( _maker_market_fee );
+   result.fees.emplace_back( _taker_market_fee );
+   result.fees.emplace_back( _pool_taker_fee );
 
-   const auto old_virtual_value = _pool->virtual_value;
-   if( op.amount_to_sell.asset_id == _pool->asset_a )
+   return result;
+} FC_CAPTURE_AND_RETHROW( (op) ) }
+
+void_result liquidity_pool_route_exchange_evaluator::do_evaluate(
+      const liquidity_pool_route_exchange_operation& op)
+{ try {
+   const database& d = db();
+
+   FC_ASSERT( HARDFORK_LIQUIDITY_POOL_ROUTE_PASSED( d.head_block_time() ),
+              "Not allowed until the liquidity pool route hardfork" );
+
+   _hops.clear();
+   _hops.reserve( op.pools.size() );
+   asset amount_to_sell = op.amount_to_sell;
+   const asset_object* sell_asset = &amount_to_sell.asset_id(d);
+   FC_ASSERT( is_authorized_asset( d, *fee_paying_account, *sell_asset ),
+              "The account is unauthorized by asset ${a}", ("a", sell_asset->symbol) );
+   for( const liquidity_pool_id_type& pool_id : op.pools )
    {
-      d.modify( *_pool, [&op,this]( liquidity_pool_object& lpo ){
-         lpo.balance_a += _pool_receives.amount;
-         lpo.balance_b -= _pool_pays.amount;
-         lpo.update_virtual_value();
-      });
+      hop h;
+      h.pool = &pool_id(d);
+      FC_ASSERT( h.pool->balance_a > 0 && h.pool->balance_b > 0,
+                 "The pool ${p} has not been initialized", ("p", pool_id) );
+      FC_ASSERT( amount_to_sell.asset_id == h.pool->asset_a || amount_to_sell.asset_id == h.pool->asset_b,
+                 "Asset type mismatch in the pool ${p}", ("p", pool_id) );
+
+      h.sell_asset = sell_asset;
+      h.receive_asset = &( amount_to_sell.asset_id == h.pool->asset_a ? h.pool->asset_b : h.pool->asset_a )(d);
+      FC_ASSERT( is_authorized_asset( d, *fee_paying_account, *h.receive_asset ),
+                 "The account is unauthorized by asset ${a}", ("a", h.receive_asset->symbol) );
+
+      h.amount_to_sell = amount_to_sell;
+      h.amounts = calculate_liquidity_pool_exchange( d, *h.pool, *h.sell_asset, *h.receive_asset, amount_to_sell );
+      FC_ASSERT( h.amounts.account_receives.amount > 0, "Aborting due to zero outcome in the pool ${p}",
+                 ("p", pool_id) );
+
+      // what the pool pays is sold to the next one
+      amount_to_sell = h.amounts.account_receives;
+      sell_asset = h.receive_asset;
+      _hops.push_back( h );
    }
-   else
+
+   FC_ASSERT( amount_to_sell.asset_id == op.min_to_receive.asset_id, "Asset type mismatch in the last pool" );
+   FC_ASSERT( amount_to_sell.amount >= op.min_to_receive.amount, "Unable to exchange at expected price" );
+
+   return void_result();
+} FC_CAPTURE_AND_RETHROW( (op) ) }
+
+generic_exchange_operation_result liquidity_pool_route_exchange_evaluator::do_apply(
+      const liquidity_pool_route_exchange_operation& op)
+{ try {
+   database& d = db();
+   generic_exchange_operation_result result;
+
+   // The amounts exchanged between the pools never reach the balances of the account
+   d.adjust_balance( op.account, -op.amount_to_sell );
+   d.adjust_balance( op.account, _hops.back().amounts.account_receives );
+
+   for( const hop& h : _hops )
    {
-      d.modify( *_pool, [&op,this]( liquidity_pool_object& lpo ){
-         lpo.balance_b += _pool_receives.amount;
-         lpo.balance_a -= _pool_pays.amount;
-         lpo.update_virtual_value();
-      });
-   }
+      const liquidity_pool_exchange_amounts& amounts = h.amounts;
 
-   FC_ASSERT( _pool->balance_a > 0 && _pool->balance_b > 0, "Internal error" );
-   FC_ASSERT( _pool->virtual_value >= old_virtual_value, "Internal error" );
+      apply_liquidity_pool_exchange( d, *fee_paying_account, *h.pool, *h.sell_asset, *h.receive_asset,
+                                     h.amount_to_sell, amounts );
+
+      result.fees.emplace_back( amounts.maker_market_fee );
+      result.fees.emplace_back( amounts.taker_market_fee );
+      result.fees.emplace_back( amounts.pool_taker_fee );
+   }
 
    result.paid.emplace_back( op.amount_to_sell );
-   result.received.emplace_back( _account_receives );
-   result.fees.emplace_back( _maker_market_fee );
-   result.fees.emplace_back( _taker_market_fee );
-   result.fees.emplace_back( _pool_taker_fee );
+   result.received.emplace_back( _hops.back().amounts.account_receives );
 
    return result;
 } FC_CAPTURE_AND_RETHROW( (op) ) }
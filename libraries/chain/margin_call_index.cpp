@@ -0,0 +1,85 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/margin_call_index.hpp>
+
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/market_object.hpp>
+
+namespace graphene { namespace chain {
+
+bool margin_call_index::by_collateralization::operator()( const call_order_object* a,
+                                                          const call_order_object* b )const
+{
+   const price a_collateralization = a->collateralization();
+   const price b_collateralization = b->collateralization();
+   if( a_collateralization < b_collateralization )
+      return true;
+   if( b_collateralization < a_collateralization )
+      return false;
+   return a->id < b->id;
+}
+
+void margin_call_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const call_order_object*>(&obj) ); // for debug only
+   add( static_cast<const call_order_object&>(obj) );
+}
+
+void margin_call_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const call_order_object*>(&obj) ); // for debug only
+   remove( static_cast<const call_order_object&>(obj) );
+}
+
+void margin_call_index::about_to_modify( const object& before )
+{
+   // The position is sorted by its current collateralization, so it is taken out before it changes
+   assert( dynamic_cast<const call_order_object*>(&before) ); // for debug only
+   remove( static_cast<const call_order_object&>(before) );
+}
+
+void margin_call_index::object_modified( const object& after )
+{
+   assert( dynamic_cast<const call_order_object*>(&after) ); // for debug only
+   add( static_cast<const call_order_object&>(after) );
+}
+
+void margin_call_index::add( const call_order_object& position )
+{
+   _positions[ position.debt_type() ].insert( &position );
+}
+
+void margin_call_index::remove( const call_order_object& position )
+{
+   auto itr = _positions.find( position.debt_type() );
+   FC_ASSERT( itr != _positions.end() );
+   itr->second.erase( &position );
+   if( itr->second.empty() )
+      _positions.erase( itr );
+}
+
+const margin_call_index::position_set* margin_call_index::get_positions( asset_id_type debt_asset )const
+{
+   auto itr = _positions.find( debt_asset );
+   if( itr == _positions.end() )
+      return nullptr;
+   return &itr->second;
+}
+
+const call_order_object* margin_call_index::get_least_collateralized( asset_id_type debt_asset )const
+{
+   const position_set* positions = get_positions( debt_asset );
+   if( positions == nullptr )
+      return nullptr;
+   return *positions->begin();
+}
+
+bool margin_call_index::has_callable_position( const asset_bitasset_data_object& bitasset )const
+{
+   const call_order_object* least = get_least_collateralized( bitasset.asset_id );
+   return least != nullptr && !( bitasset.current_maintenance_collateralization < least->collateralization() );
+}
+
+} } // graphene::chain
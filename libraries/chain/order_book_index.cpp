@@ -0,0 +1,97 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/order_book_index.hpp>
+
+#include <graphene/chain/market_object.hpp>
+
+namespace graphene { namespace chain {
+
+void order_book_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const limit_order_object*>(&obj) ); // for debug only
+   const limit_order_object& o = static_cast<const limit_order_object&>(obj);
+   add( o.sell_price, o.id, o.for_sale );
+}
+
+void order_book_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const limit_order_object*>(&obj) ); // for debug only
+   const limit_order_object& o = static_cast<const limit_order_object&>(obj);
+   subtract( o.sell_price, o.id, o.for_sale );
+}
+
+void order_book_index::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const limit_order_object*>(&before) ); // for debug only
+   const limit_order_object& o = static_cast<const limit_order_object&>(before);
+   _order_being_modified = std::make_pair( o.sell_price, o.for_sale );
+}
+
+void order_book_index::object_modified( const object& after )
+{
+   assert( dynamic_cast<const limit_order_object*>(&after) ); // for debug only
+   FC_ASSERT( _order_being_modified.valid() );
+   const limit_order_object& o = static_cast<const limit_order_object&>(after);
+   const price& old_price = _order_being_modified->first;
+   if( old_price == o.sell_price )
+   {
+      // Fills only change the amount for sale
+      auto itr = _levels.find( o.sell_price );
+      FC_ASSERT( itr != _levels.end() );
+      itr->second.for_sale += o.for_sale - _order_being_modified->second;
+   }
+   else
+   {
+      subtract( old_price, o.id, _order_being_modified->second );
+      add( o.sell_price, o.id, o.for_sale );
+   }
+   _order_being_modified.reset();
+}
+
+void order_book_index::add( const price& sell_price, limit_order_id_type order, share_type for_sale )
+{
+   price_level& level = _levels[sell_price];
+   level.for_sale += for_sale;
+   level.orders.insert( order );
+}
+
+void order_book_index::subtract( const price& sell_price, limit_order_id_type order, share_type for_sale )
+{
+   auto itr = _levels.find( sell_price );
+   FC_ASSERT( itr != _levels.end() );
+   itr->second.orders.erase( order );
+   if( itr->second.orders.empty() )
+      _levels.erase( itr );
+   else
+      itr->second.for_sale -= for_sale;
+}
+
+std::pair<order_book_index::level_iterator, order_book_index::level_iterator> order_book_index::get_levels(
+      asset_id_type sell, asset_id_type receive )const
+{
+   return std::make_pair( _levels.lower_bound( price::max( sell, receive ) ),
+                          _levels.upper_bound( price::min( sell, receive ) ) );
+}
+
+bool order_book_index::is_first_in_line( const limit_order_object& order )const
+{
+   const auto levels = get_levels( order.sell_asset_id(), order.receive_asset_id() );
+   if( levels.first == levels.second )
+      return true;
+   const auto& best = *levels.first;
+   if( best.first > order.sell_price )
+      return false;
+   // The order is the oldest of the best level, or better than the best level if it is not in the book
+   return best.first < order.sell_price || !( *best.second.orders.begin() < order.id );
+}
+
+bool order_book_index::is_crossed_by( const price& sell_price )const
+{
+   const price max_price = ~sell_price;
+   const auto levels = get_levels( max_price.base.asset_id, max_price.quote.asset_id );
+   return levels.first != levels.second && !( levels.first->first < max_price );
+}
+
+} } // graphene::chain
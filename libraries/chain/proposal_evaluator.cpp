@@ -103,6 +103,14 @@ struct proposal_operation_hardfork_visitor
          FC_ASSERT(!op.new_parameters.current_fees->exists<liquidity_pool_exchange_operation>(),
                    "Unable to define fees for liquidity pool operations prior to the LP hardfork");
       }
+      if (!HARDFORK_ASSET_PRICE_BATCH_PASSED(block_time)) {
+         FC_ASSERT(!op.new_parameters.current_fees->exists<asset_price_publish_batch_operation>(),
+                   "Unable to define fees for batched asset price publication prior to its hardfork");
+      }
+      if (!HARDFORK_LIQUIDITY_POOL_ROUTE_PASSED(block_time)) {
+         FC_ASSERT(!op.new_parameters.current_fees->exists<liquidity_pool_route_exchange_operation>(),
+                   "Unable to define fees for routed liquidity pool exchanges prior to its hardfork");
+      }
    }
    void operator()(const graphene::chain::htlc_create_operation &op) const {
       FC_ASSERT( block_time >= HARDFORK_CORE_1468_TIME, "Not allowed until hardfork 1468" );
@@ -128,6 +136,14 @@ struct proposal_operation_hardfork_visitor
    void operator()(const graphene::chain::liquidity_pool_exchange_operation &op) const {
       FC_ASSERT( HARDFORK_LIQUIDITY_POOL_PASSED(block_time), "Not allowed until the LP hardfork" );
    }
+   void operator()(const graphene::chain::asset_price_publish_batch_operation &op) const {
+      FC_ASSERT( HARDFORK_ASSET_PRICE_BATCH_PASSED(block_time),
+                 "Not allowed until the batched asset price publication hardfork" );
+   }
+   void operator()(const graphene::chain::liquidity_pool_route_exchange_operation &op) const {
+      FC_ASSERT( HARDFORK_LIQUIDITY_POOL_ROUTE_PASSED(block_time),
+                 "Not allowed until the liquidity pool route hardfork" );
+   }
 
    // loop and self visit in proposals
    void operator()(const graphene::chain::proposal_create_operation &v) const {
@@ -290,6 +306,10 @@ void_result proposal_update_evaluator::do_evaluate(const proposal_update_operati
 
    _proposal = &o.proposal(d);
 
+   // Expired proposals may wait a few blocks to be removed, see clear_expired_proposals
+   if( HARDFORK_EXPIRATION_SWEEP_PASSED( d.head_block_time() ) )
+      FC_ASSERT( _proposal->expiration_time > d.head_block_time(), "This proposal has expired." );
+
    if( _proposal->review_period_time && d.head_block_time() >= *_proposal->review_period_time )
       FC_ASSERT( o.active_approvals_to_add.empty() && o.owner_approvals_to_add.empty(),
                  "This proposal is in its review period. No new approvals may be added." );
@@ -333,7 +353,7 @@ void_result proposal_update_evaluator::do_apply(const proposal_update_operation&
    if( _proposal->review_period_time )
       return void_result();
 
-   if( _proposal->is_authorized_to_execute(d) )
+   if( d.is_proposal_authorized_to_execute(*_proposal) )
    {
       // All required approvals are satisfied. Execute!
       _executed_proposal = true;
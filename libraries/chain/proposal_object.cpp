@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/authority_cache.hpp>
 #include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/transaction_evaluation_state.hpp>
 #include <graphene/chain/proposal_object.hpp>
@@ -51,6 +52,36 @@ bool proposal_object::is_authorized_to_execute(database& db) const
    return true;
 }
 
+bool required_approval_index::is_authorized_to_execute( database& db, const proposal_object& p )
+{
+   if( _authorities == nullptr )
+   {
+      ++_checks;
+      return p.is_authorized_to_execute( db );
+   }
+
+   authorization_check check;
+   check.authority_revision = _authorities->get_authority_revision();
+   check.max_authority_depth = db.get_global_properties().parameters.max_authority_depth;
+   check.allow_non_immediate_owner = ( db.head_block_time() >= HARDFORK_CORE_584_TIME );
+
+   auto itr = _unauthorized.find( p.id );
+   if( itr != _unauthorized.end() && itr->second == check )
+   {
+      ++_skipped_checks;
+      return false;
+   }
+
+   ++_checks;
+   if( p.is_authorized_to_execute( db ) )
+   {
+      _unauthorized.erase( p.id );
+      return true;
+   }
+   _unauthorized[ p.id ] = check;
+   return false;
+}
+
 void required_approval_index::object_inserted( const object& obj )
 {
     assert( dynamic_cast<const proposal_object*>(&obj) );
@@ -90,6 +121,7 @@ void required_approval_index::object_removed( const object& obj )
        remove( a, p.id );
     for( const auto& a : p.available_owner_approvals )
        remove( a, p.id );
+    _unauthorized.erase( p.id );
 }
 
 void required_approval_index::insert_or_remove_delta( proposal_id_type p,
@@ -123,6 +155,7 @@ void required_approval_index::about_to_modify( const object& before )
     const proposal_object& p = static_cast<const proposal_object&>(before);
     available_active_before_modify = p.available_active_approvals;
     available_owner_before_modify  = p.available_owner_approvals;
+    available_key_before_modify    = p.available_key_approvals;
 }
 
 void required_approval_index::object_modified( const object& after )
@@ -130,6 +163,10 @@ void required_approval_index::object_modified( const object& after )
     const proposal_object& p = static_cast<const proposal_object&>(after);
     insert_or_remove_delta( p.id, available_active_before_modify, p.available_active_approvals );
     insert_or_remove_delta( p.id, available_owner_before_modify,  p.available_owner_approvals );
+    if( available_active_before_modify != p.available_active_approvals
+          || available_owner_before_modify != p.available_owner_approvals
+          || available_key_before_modify != p.available_key_approvals )
+       _unauthorized.erase( p.id );
 }
 
 } } // graphene::chain
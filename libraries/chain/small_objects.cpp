@@ -142,7 +142,8 @@ FC_REFLECT_DERIVED_NO_TYPENAME(
    (account)
 )
 
-FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::transaction_history_object, (graphene::db::object), (trx)(trx_id) )
+FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::transaction_history_object, (graphene::db::object),
+                                (trx_id)(expiration)(block_num)(trx_in_block) )
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::withdraw_permission_object, (graphene::db::object),
                     (withdraw_from_account)
@@ -0,0 +1,120 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/top_holders_index.hpp>
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <algorithm>
+
+namespace graphene { namespace chain {
+
+void top_holders_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const account_balance_object*>(&obj) ); // for debug only
+   const account_balance_object& b = static_cast<const account_balance_object&>(obj);
+   update( b.asset_type, b.owner, 0, b.balance );
+}
+
+void top_holders_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const account_balance_object*>(&obj) ); // for debug only
+   const account_balance_object& b = static_cast<const account_balance_object&>(obj);
+   update( b.asset_type, b.owner, b.balance, 0 );
+}
+
+void top_holders_index::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const account_balance_object*>(&before) ); // for debug only
+   const account_balance_object& b = static_cast<const account_balance_object&>(before);
+   _balance_being_modified = b.balance;
+}
+
+void top_holders_index::object_modified( const object& after )
+{
+   assert( dynamic_cast<const account_balance_object*>(&after) ); // for debug only
+   FC_ASSERT( _balance_being_modified.valid() );
+   const account_balance_object& b = static_cast<const account_balance_object&>(after);
+   update( b.asset_type, b.owner, *_balance_being_modified, b.balance );
+   _balance_being_modified.reset();
+}
+
+void top_holders_index::update( asset_id_type asset, account_id_type owner, share_type before, share_type after )
+{
+   if( before == after )
+      return;
+   auto asset_itr = _assets.find( asset );
+   if( asset_itr == _assets.end() || !asset_itr->second.complete )
+      return;
+   tracked_asset& tracked = asset_itr->second;
+   holder_set& holders = tracked.holders;
+
+   // The holders which are not listed are behind the last listed holder, if the list is full
+   const bool was_full = ( holders.size() >= tracked.capacity );
+   const auto boundary = ( holders.empty() ? std::make_pair( share_type(0), account_id_type() ) : *holders.rbegin() );
+   const bool was_listed = ( before > 0 && holders.erase( std::make_pair( before, owner ) ) > 0 );
+   if( was_listed && was_full && ( after <= 0 || holder_compare()( boundary, std::make_pair( after, owner ) ) ) )
+   {
+      // A holder which is not listed may now be larger
+      tracked.complete = false;
+      holders.clear();
+      return;
+   }
+   if( after > 0 )
+   {
+      holders.emplace( after, owner );
+      if( holders.size() > tracked.capacity )
+         holders.erase( std::prev( holders.end() ) );
+   }
+}
+
+void top_holders_index::track( const flat_map<asset_id_type, uint16_t>& holder_counts )
+{
+   for( auto itr = _assets.begin(); itr != _assets.end(); )
+   {
+      if( holder_counts.find( itr->first ) == holder_counts.end() )
+         itr = _assets.erase( itr );
+      else
+         ++itr;
+   }
+   for( const auto& count : holder_counts )
+   {
+      tracked_asset& tracked = _assets[ count.first ];
+      if( tracked.capacity != count.second )
+      {
+         tracked.capacity = count.second;
+         tracked.complete = false;
+         tracked.holders.clear();
+      }
+   }
+}
+
+const top_holders_index::holder_set& top_holders_index::get_top_holders( const database& db, asset_id_type asset )
+{
+   auto asset_itr = _assets.find( asset );
+   FC_ASSERT( asset_itr != _assets.end(), "Asset ${a} is not tracked", ("a", asset) );
+   tracked_asset& tracked = asset_itr->second;
+   if( !tracked.complete )
+   {
+      ++_lookups;
+      tracked.holders.clear();
+      // Select the largest holders without keeping the other balances sorted
+      vector< std::pair<share_type, account_id_type> > candidates;
+      const auto& bal_idx = db.get_index_type< account_balance_index >().indices().get< by_asset_owner >();
+      const auto range = bal_idx.equal_range( boost::make_tuple( asset ) );
+      for( const account_balance_object& b : boost::make_iterator_range( range.first, range.second ) )
+      {
+         if( b.balance > 0 )
+            candidates.emplace_back( b.balance, b.owner );
+      }
+      const size_t count = std::min<size_t>( tracked.capacity, candidates.size() );
+      std::partial_sort( candidates.begin(), candidates.begin() + count, candidates.end(), holder_compare() );
+      tracked.holders.insert( candidates.begin(), candidates.begin() + count );
+      tracked.complete = true;
+   }
+   return tracked.holders;
+}
+
+} } // graphene::chain
@@ -0,0 +1,208 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/vote_tally_index.hpp>
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/global_property_object.hpp>
+#include <graphene/chain/vesting_balance_object.hpp>
+
+namespace graphene { namespace chain {
+
+void vote_tally_index::object_inserted( const object& obj )
+{
+   stake_changed( account_id_type( obj.id ) );
+}
+
+void vote_tally_index::object_removed( const object& obj )
+{
+   if( !_valid )
+      return;
+   // Accounts are only removed when their creation is undone. Stake voting through them can not be followed.
+   const account_id_type account( obj.id );
+   const stake_record& record = get_record( account );
+   if( record.stake != 0 || record.opinion_stake != 0 )
+      _valid = false;
+   else
+      stake_changed( account );
+}
+
+void vote_tally_index::about_to_modify( const object& before )
+{
+   _options_being_modified.reset();
+   if( !_valid )
+      return;
+   assert( dynamic_cast<const account_object*>(&before) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(before);
+   if( get_record( a.id ).opinion_stake != 0 )
+      _options_being_modified = a.options;
+}
+
+void vote_tally_index::object_modified( const object& after )
+{
+   if( !_valid )
+      return;
+   assert( dynamic_cast<const account_object*>(&after) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(after);
+
+   // The voting account, the membership or the cashback balance of the account may have changed
+   stake_changed( a.id );
+
+   if( !_options_being_modified.valid() )
+      return;
+   const account_options& before = *_options_being_modified;
+   if( before.votes != a.options.votes || before.num_witness != a.options.num_witness
+         || before.num_committee != a.options.num_committee )
+   {
+      const uint64_t opinion_stake = get_record( a.id ).opinion_stake;
+      apply_stake( a.id, before, opinion_stake, false );
+      apply_stake( a.id, a.options, opinion_stake, true );
+   }
+   _options_being_modified.reset();
+}
+
+void vote_tally_index::stake_changed( account_id_type account )
+{
+   if( _valid )
+      _changed_accounts.insert( account.instance.value );
+}
+
+bool vote_tally_index::is_valid_for( const global_property_object& gpo )const
+{
+   return _valid && gpo.parameters.count_non_member_votes
+          && _vote_id_count == gpo.next_available_vote_id
+          && _maximum_witness_count == gpo.parameters.maximum_witness_count
+          && _maximum_committee_count == gpo.parameters.maximum_committee_count;
+}
+
+vote_tally_index::stake_record& vote_tally_index::get_record( account_id_type account )
+{
+   if( _records.size() <= account.instance.value )
+      _records.resize( account.instance.value + 1 );
+   return _records[account.instance.value];
+}
+
+void vote_tally_index::apply_stake( account_id_type opinion_account, const account_options& opinions,
+                                    uint64_t stake, bool add )
+{
+   if( stake == 0 )
+      return;
+   // Unsigned arithmetic wraps around, so that removing a stake exactly reverts adding it
+   const uint64_t delta = add ? stake : uint64_t(0) - stake;
+
+   get_record( opinion_account ).opinion_stake += delta;
+
+   for( vote_id_type id : opinions.votes )
+   {
+      uint32_t offset = id.instance();
+      // if they somehow managed to specify an illegal offset, ignore it.
+      if( offset < _vote_tally.size() )
+         _vote_tally[offset] += delta;
+   }
+
+   // votes for a number greater than the maximum count are turned into votes for the maximum count
+   if( opinions.num_witness <= _maximum_witness_count )
+   {
+      uint16_t offset = std::min( size_t(opinions.num_witness/2), _witness_count_histogram.size() - 1 );
+      _witness_count_histogram[offset] += delta;
+   }
+   if( opinions.num_committee <= _maximum_committee_count )
+   {
+      uint16_t offset = std::min( size_t(opinions.num_committee/2), _committee_count_histogram.size() - 1 );
+      _committee_count_histogram[offset] += delta;
+   }
+}
+
+void vote_tally_index::refresh( const database& db, account_id_type account )
+{
+   uint64_t stake = 0;
+   account_id_type opinion_account = account;
+
+   const account_object* stake_account = db.find( account );
+   if( stake_account != nullptr )
+   {
+      const account_statistics_object& stats = stake_account->statistics( db );
+      if( stats.has_some_core_voting() )
+      {
+         if( stake_account->options.voting_account != GRAPHENE_PROXY_TO_SELF_ACCOUNT )
+            opinion_account = stake_account->options.voting_account;
+         stake = stats.total_core_in_orders.value
+               + (stake_account->cashback_vb.valid() ? (*stake_account->cashback_vb)(db).balance.amount.value: 0)
+               + stats.core_in_balance.value;
+      }
+   }
+
+   // Copied, as apply_stake() may grow the records
+   const stake_record previous = get_record( account );
+   if( previous.stake == stake && previous.opinion_account == opinion_account )
+      return;
+
+   if( previous.stake != 0 )
+   {
+      apply_stake( previous.opinion_account, previous.opinion_account( db ).options, previous.stake, false );
+      _total_voting_stake -= previous.stake;
+   }
+   if( stake != 0 )
+   {
+      apply_stake( opinion_account, opinion_account( db ).options, stake, true );
+      _total_voting_stake += stake;
+   }
+
+   stake_record& record = get_record( account );
+   record.stake = stake;
+   record.opinion_account = opinion_account;
+}
+
+void vote_tally_index::rebuild( const database& db )
+{
+   const global_property_object& gpo = db.get_global_properties();
+
+   _valid = false;
+   _changed_accounts.clear();
+   _records.clear();
+
+   _vote_id_count = gpo.next_available_vote_id;
+   _maximum_witness_count = gpo.parameters.maximum_witness_count;
+   _maximum_committee_count = gpo.parameters.maximum_committee_count;
+   _vote_tally.assign( _vote_id_count, 0 );
+   _witness_count_histogram.assign( _maximum_witness_count / 2 + 1, 0 );
+   _committee_count_histogram.assign( _maximum_committee_count / 2 + 1, 0 );
+   _total_voting_stake = 0;
+
+   const auto& stats_idx = db.get_index_type< account_stats_index >().indices().get< by_maintenance_seq >();
+   for( auto itr = stats_idx.lower_bound( true ); itr != stats_idx.end(); ++itr )
+   {
+      if( itr->has_some_core_voting() )
+         refresh( db, itr->owner );
+   }
+
+   _valid = true;
+}
+
+void vote_tally_index::update( const database& db )
+{
+   if( !is_valid_for( db.get_global_properties() ) )
+   {
+      rebuild( db );
+      return;
+   }
+
+   for( uint64_t instance : _changed_accounts )
+   {
+      const stake_record& record = get_record( account_id_type( instance ) );
+      if( record.stake != 0 && db.find( record.opinion_account ) == nullptr )
+      {
+         rebuild( db );
+         return;
+      }
+   }
+
+   // The order does not matter, every change is a commutative addition
+   for( uint64_t instance : _changed_accounts )
+      refresh( db, account_id_type( instance ) );
+   _changed_accounts.clear();
+}
+
+} } // graphene::chain
@@ -23,6 +23,7 @@
  */
 
 #include <graphene/api_helper_indexes/api_helper_indexes.hpp>
+#include <graphene/chain/account_object.hpp>
 #include <graphene/chain/liquidity_pool_object.hpp>
 #include <graphene/chain/market_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
@@ -125,6 +126,51 @@ const flat_set<liquidity_pool_id_type>& asset_in_liquidity_pools_index::get_liqu
    return empty_set;
 }
 
+void asset_holders_count_index::object_inserted( const object& objct )
+{ try {
+   const account_balance_object& o = static_cast<const account_balance_object&>( objct );
+   if( o.balance != 0 )
+      ++holders_count[ o.asset_type ];
+} FC_CAPTURE_AND_RETHROW( (objct) ); }
+
+void asset_holders_count_index::object_removed( const object& objct )
+{ try {
+   const account_balance_object& o = static_cast<const account_balance_object&>( objct );
+   if( o.balance != 0 )
+   {
+      auto itr = holders_count.find( o.asset_type );
+      if( itr != holders_count.end() ) // should always be true
+         --itr->second;
+   }
+} FC_CAPTURE_AND_RETHROW( (objct) ); }
+
+void asset_holders_count_index::about_to_modify( const object& objct )
+{ try {
+   const account_balance_object& o = static_cast<const account_balance_object&>( objct );
+   held_before_modify = ( o.balance != 0 );
+} FC_CAPTURE_AND_RETHROW( (objct) ); }
+
+void asset_holders_count_index::object_modified( const object& objct )
+{ try {
+   const account_balance_object& o = static_cast<const account_balance_object&>( objct );
+   const bool held = ( o.balance != 0 );
+   if( held && !held_before_modify )
+      ++holders_count[ o.asset_type ];
+   else if( !held && held_before_modify )
+   {
+      auto itr = holders_count.find( o.asset_type );
+      if( itr != holders_count.end() ) // should always be true
+         --itr->second;
+   }
+} FC_CAPTURE_AND_RETHROW( (objct) ); }
+
+uint64_t asset_holders_count_index::get_holders_count( const asset_id_type& asst )const
+{
+   auto itr = holders_count.find( asst );
+   if( itr == holders_count.end() ) return 0;
+   return itr->second;
+}
+
 namespace detail
 {
 
@@ -189,15 +235,18 @@ void api_helper_indexes::plugin_startup()
    for( const auto& account : database().get_index_type< account_index >().indices() )
       account_members.object_inserted( account );
 
-   auto& approvals = *database().add_secondary_index< primary_index<proposal_index>, required_approval_index >();
-   for( const auto& proposal : database().get_index_type< proposal_index >().indices() )
-      approvals.object_inserted( proposal );
+   // The approvals of the proposals are indexed by the database itself, see required_approval_index
 
    asset_in_liquidity_pools_idx = database().add_secondary_index< primary_index<liquidity_pool_index>,
                                                         asset_in_liquidity_pools_index >();
    for( const auto& pool : database().get_index_type<liquidity_pool_index>().indices() )
       asset_in_liquidity_pools_idx->object_inserted( pool );
 
+   asset_holders_count_idx = database().add_secondary_index< primary_index<account_balance_index>,
+                                                             asset_holders_count_index >();
+   for( const auto& balance : database().get_index_type<account_balance_index>().indices() )
+      asset_holders_count_idx->object_inserted( balance );
+
 }
 
 } }
@@ -71,6 +71,25 @@ class asset_in_liquidity_pools_index: public secondary_index
       flat_map<asset_id_type, flat_set<liquidity_pool_id_type>> asset_in_pools_map;
 };
 
+/**
+ *  @brief This secondary index counts the accounts holding a non-zero balance of each asset.
+ */
+class asset_holders_count_index : public secondary_index
+{
+   public:
+      virtual void object_inserted( const object& obj ) override;
+      virtual void object_removed( const object& obj ) override;
+      virtual void about_to_modify( const object& before ) override;
+      virtual void object_modified( const object& after ) override;
+
+      uint64_t get_holders_count( const asset_id_type& asset )const;
+
+   private:
+      std::map<asset_id_type, uint64_t> holders_count;
+      /// Whether the balance being modified was not zero
+      bool                              held_before_modify = false;
+};
+
 namespace detail
 {
     class api_helper_indexes_impl;
@@ -96,6 +115,7 @@ class api_helper_indexes : public graphene::app::plugin
    private:
       amount_in_collateral_index* amount_in_collateral_idx = nullptr;
       asset_in_liquidity_pools_index* asset_in_liquidity_pools_idx = nullptr;
+      asset_holders_count_index* asset_holders_count_idx = nullptr;
 };
 
 } } //graphene::template
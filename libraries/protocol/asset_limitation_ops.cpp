@@ -31,13 +31,28 @@ void asset_limitation_object_update_operation::validate() const
        usd_price.validate();
    }
 
+   void asset_price_publish_batch_operation::validate() const {
+       FC_ASSERT(fee.amount >= 0);
+       FC_ASSERT(!usd_prices.empty(), "At least one asset price should be published");
+       for (const auto &entry : usd_prices) {
+          FC_ASSERT(!entry.first.empty());
+          entry.second.validate();
+       }
+   }
+
+   share_type asset_price_publish_batch_operation::calculate_fee(const fee_parameters_type &k) const {
+       return k.fee + calculate_data_fee(fc::raw::pack_size(usd_prices), k.price_per_kbyte);
+   }
+
 } // namespace protocol
 } // namespace graphene
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_create_operation::fee_parameters_type)
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_update_operation::fee_parameters_type)
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_operation::fee_parameters_type)
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_batch_operation::fee_parameters_type)
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_create_operation)
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_update_operation)
-GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_operation)
\ No newline at end of file
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_operation)
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_batch_operation)
@@ -98,6 +98,16 @@ namespace graphene { namespace protocol {
       }
       return _calculated_merkle_root;
    }
+
+   uint64_t signed_block::get_packed_size()const
+   {
+      // Packed as the header, followed by the number of transactions and the transactions
+      uint64_t size = fc::raw::pack_size( static_cast<const signed_block_header&>( *this ) )
+                    + fc::raw::pack_size( fc::unsigned_int( transactions.size() ) );
+      for( const auto& trx : transactions )
+         size += trx.get_serialized_size();
+      return size;
+   }
 } }
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::block_header)
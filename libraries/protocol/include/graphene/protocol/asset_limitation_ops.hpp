@@ -88,6 +88,35 @@ struct asset_limitation_object_update_operation : public base_operation
       void validate() const;
    };
 
+   /**
+    * Publish the USD-denominated prices of several external assets in a single operation
+    *
+    * Each entry has the same effect as an individual @ref asset_price_publish_operation
+    * for the same symbol and price.
+    */
+   struct asset_price_publish_batch_operation : public base_operation
+   {
+      struct fee_parameters_type
+      {
+         uint64_t fee = GRAPHENE_BLOCKCHAIN_PRECISION;
+         uint32_t price_per_kbyte = 10; ///< charged on the size of the published prices
+      };
+
+      asset_price_publish_batch_operation() {}
+
+      asset fee;
+      account_id_type fee_paying_account;
+      /// USD-price expressed as a ratio, keyed by the ticker symbol of each asset
+      flat_map<string, price_ratio> usd_prices;
+
+      // For future expansion
+      extensions_type extensions;
+
+      account_id_type fee_payer() const { return fee_paying_account; }
+      void validate() const;
+      share_type calculate_fee(const fee_parameters_type& k) const;
+   };
+
 } // namespace protocol
 } // namespace graphene
 
@@ -105,10 +134,16 @@ FC_REFLECT(graphene::protocol::asset_price_publish_operation::fee_parameters_typ
 FC_REFLECT(graphene::protocol::asset_price_publish_operation,
            (fee)(fee_paying_account)(symbol)(usd_price)(extensions))
 
+FC_REFLECT(graphene::protocol::asset_price_publish_batch_operation::fee_parameters_type, (fee)(price_per_kbyte))
+FC_REFLECT(graphene::protocol::asset_price_publish_batch_operation,
+           (fee)(fee_paying_account)(usd_prices)(extensions))
+
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_create_operation::fee_parameters_type)
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_update_operation::fee_parameters_type)
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_operation::fee_parameters_type)
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_batch_operation::fee_parameters_type)
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_create_operation)
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_limitation_object_update_operation)
-GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_operation)
\ No newline at end of file
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_operation)
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION(graphene::protocol::asset_price_publish_batch_operation)
@@ -60,6 +60,11 @@ namespace graphene { namespace protocol {
    {
    public:
       const checksum_type& calculate_merkle_root()const;
+      /**
+       * The size of the serialized block. The sizes of the transactions are memoized, only the header is
+       * serialized again, since it changes when the block is signed.
+       */
+      uint64_t get_packed_size()const;
       vector<processed_transaction> transactions;
    protected:
       mutable checksum_type   _calculated_merkle_root;
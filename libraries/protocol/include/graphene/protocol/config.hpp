@@ -107,6 +107,8 @@
 /** NOTE: making this a power of 2 (say 2^15) would greatly accelerate fee calcs */
 
 #define GRAPHENE_MAX_MARKET_FEE_PERCENT                         GRAPHENE_100_PERCENT
+
+#define GRAPHENE_MAX_LIQUIDITY_POOL_ROUTE_LENGTH                5 ///< most pools a routed exchange can go through
 /**
  *  These ratios are fixed point numbers with a denominator of GRAPHENE_COLLATERAL_RATIO_DENOM, the
  *  minimum maitenance collateral is therefore 1.001x and the default
@@ -126,6 +126,34 @@ namespace graphene { namespace protocol {
       void            validate()const;
    };
 
+   /**
+    * @brief Exchange through several liquidity pools in a row
+    * @ingroup operations
+    *
+    * The amount to sell is exchanged with the first pool, and what each pool pays is exchanged with the next one,
+    * all at once. Only the amount to sell and the amount received by the last pool are moved in the balances of the
+    * account.
+    */
+   struct liquidity_pool_route_exchange_operation : public base_operation
+   {
+      struct fee_parameters_type {
+         uint64_t fee           = 1 * GRAPHENE_BLOCKCHAIN_PRECISION;
+         uint64_t price_per_hop = GRAPHENE_BLOCKCHAIN_PRECISION / 2; ///< for every pool after the first one
+      };
+
+      asset                            fee;             ///< Operation fee
+      account_id_type                  account;         ///< The account who exchanges with the liquidity pools
+      vector<liquidity_pool_id_type>   pools;           ///< IDs of the liquidity pools, in the order of the exchanges
+      asset                            amount_to_sell;  ///< The amount to sell to the first pool
+      asset                            min_to_receive;  ///< The minimum amount to receive from the last pool
+
+      extensions_type extensions;  ///< Unused. Reserved for future use.
+
+      account_id_type fee_payer()const { return account; }
+      void            validate()const;
+      share_type      calculate_fee(const fee_parameters_type& k)const;
+   };
+
 } } // graphene::protocol
 
 FC_REFLECT( graphene::protocol::liquidity_pool_create_operation::fee_parameters_type, (fee) )
@@ -133,6 +161,7 @@ FC_REFLECT( graphene::protocol::liquidity_pool_delete_operation::fee_parameters_
 FC_REFLECT( graphene::protocol::liquidity_pool_deposit_operation::fee_parameters_type, (fee) )
 FC_REFLECT( graphene::protocol::liquidity_pool_withdraw_operation::fee_parameters_type, (fee) )
 FC_REFLECT( graphene::protocol::liquidity_pool_exchange_operation::fee_parameters_type, (fee) )
+FC_REFLECT( graphene::protocol::liquidity_pool_route_exchange_operation::fee_parameters_type, (fee)(price_per_hop) )
 
 FC_REFLECT( graphene::protocol::liquidity_pool_create_operation,
             (fee)(account)(asset_a)(asset_b)(share_asset)
@@ -145,15 +174,19 @@ FC_REFLECT( graphene::protocol::liquidity_pool_withdraw_operation,
             (fee)(account)(pool)(share_amount)(extensions) )
 FC_REFLECT( graphene::protocol::liquidity_pool_exchange_operation,
             (fee)(account)(pool)(amount_to_sell)(min_to_receive)(extensions) )
+FC_REFLECT( graphene::protocol::liquidity_pool_route_exchange_operation,
+            (fee)(account)(pools)(amount_to_sell)(min_to_receive)(extensions) )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_create_operation::fee_parameters_type )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_delete_operation::fee_parameters_type )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_deposit_operation::fee_parameters_type )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_withdraw_operation::fee_parameters_type )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_exchange_operation::fee_parameters_type )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_route_exchange_operation::fee_parameters_type )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_create_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_delete_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_deposit_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_withdraw_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_exchange_operation )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_route_exchange_operation )
@@ -114,7 +114,9 @@ namespace graphene { namespace protocol {
             liquidity_pool_delete_operation,
             liquidity_pool_deposit_operation,
             liquidity_pool_withdraw_operation,
-            liquidity_pool_exchange_operation
+            liquidity_pool_exchange_operation,
+            asset_price_publish_batch_operation,
+            liquidity_pool_route_exchange_operation
          > operation;
 
    /// @} // operations group
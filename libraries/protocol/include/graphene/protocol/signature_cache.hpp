@@ -0,0 +1,87 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#pragma once
+
+#include <graphene/protocol/types.hpp>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace graphene { namespace protocol {
+
+   /// Counters of a @ref signature_key_cache
+   struct signature_key_cache_stats
+   {
+      uint64_t hits = 0;     ///< recoveries answered from the cache
+      uint64_t misses = 0;   ///< recoveries computed, each one costs a secp256k1 public key recovery
+      uint64_t size = 0;     ///< number of cached keys
+      uint64_t capacity = 0; ///< maximum number of cached keys, 0 if the cache is disabled
+   };
+
+   /**
+    *  @brief A bounded cache of the public keys recovered from transaction signatures
+    *
+    *  A transaction is usually recovered once when it is received alone, and again when it is received in a block,
+    *  as a different object. The cache is shared by the whole process and keyed by the signature and the digest it
+    *  signs, so a cached key is always the key that recovery would produce.
+    *
+    *  It is safe to use from several threads. Entries are spread over shards with their own lock, and evicted in
+    *  insertion order when a shard is full.
+    */
+   class signature_key_cache
+   {
+      public:
+         static constexpr size_t default_capacity = 50000;
+
+         /// The cache used by @ref signed_transaction::get_signature_keys
+         static signature_key_cache& instance();
+
+         /// Recover the public key that produced @p signature of @p digest
+         public_key_type recover( const fc::ecc::compact_signature& signature, const digest_type& digest );
+
+         /// Change the maximum number of cached keys, 0 disables the cache. Cached keys are dropped.
+         void set_capacity( size_t capacity );
+
+         signature_key_cache_stats get_stats()const;
+
+      private:
+         signature_key_cache();
+
+         struct cache_key
+         {
+            digest_type                  digest;
+            fc::ecc::compact_signature   signature;
+
+            bool operator==( const cache_key& other )const
+            { return digest == other.digest && signature == other.signature; }
+         };
+
+         struct cache_key_hash
+         {
+            size_t operator()( const cache_key& key )const;
+         };
+
+         struct shard
+         {
+            mutable std::mutex                                           mutex;
+            std::unordered_map< cache_key, public_key_type, cache_key_hash > keys;
+            std::deque< cache_key >                                      insertion_order;
+         };
+
+         static constexpr size_t shard_count = 16;
+
+         shard& shard_for( const cache_key& key );
+
+         std::array< shard, shard_count > _shards;
+         std::atomic< size_t >            _shard_capacity;
+         std::atomic< uint64_t >          _hits;
+         std::atomic< uint64_t >          _misses;
+   };
+
+} } // graphene::protocol
+
+FC_REFLECT( graphene::protocol::signature_key_cache_stats, (hits)(misses)(size)(capacity) )
@@ -275,13 +275,34 @@ namespace graphene { namespace protocol {
    {
       processed_transaction( const signed_transaction& trx = signed_transaction() )
          : precomputable_transaction(trx){}
+      /// Keeps the results already computed for @p trx
+      processed_transaction( const precomputable_transaction& trx )
+         : precomputable_transaction(trx){}
       virtual ~processed_transaction() = default;
 
       vector<operation_result> operation_results;
 
       digest_type merkle_digest()const;
+
+      /**
+       * The size of the transaction as it is serialized in a block, with its signatures and operation results.
+       * It is computed once, so it must not be called before the operation results are set.
+       */
+      uint64_t get_serialized_size()const;
+   protected:
+      mutable uint64_t _serialized_size = 0;
    };
 
+   /// Counters of the memoized transaction sizes, see @ref get_packed_size_stats
+   struct packed_size_stats
+   {
+      uint64_t computed = 0; ///< sizes computed by serializing a transaction
+      uint64_t reused = 0;   ///< sizes answered without serializing the transaction again
+   };
+
+   /// The counters of the sizes memoized by @ref precomputable_transaction and @ref processed_transaction
+   packed_size_stats get_packed_size_stats();
+
    /// @} transactions group
 
 } } // graphene::protocol
@@ -291,6 +312,7 @@ FC_REFLECT( graphene::protocol::transaction, (ref_block_num)(ref_block_prefix)(e
 FC_REFLECT_DERIVED( graphene::protocol::signed_transaction, (graphene::protocol::transaction), (signatures) )
 FC_REFLECT_DERIVED( graphene::protocol::precomputable_transaction, (graphene::protocol::signed_transaction), )
 FC_REFLECT_DERIVED( graphene::protocol::processed_transaction, (graphene::protocol::precomputable_transaction), (operation_results) )
+FC_REFLECT( graphene::protocol::packed_size_stats, (computed)(reused) )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::transaction)
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::signed_transaction)
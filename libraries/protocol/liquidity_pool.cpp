@@ -65,6 +65,29 @@ void liquidity_pool_exchange_operation::validate()const
              "ID of the two assets should not be the same" );
 }
 
+void liquidity_pool_route_exchange_operation::validate()const
+{
+   FC_ASSERT( fee.amount >= 0, "Fee should not be negative" );
+   FC_ASSERT( !pools.empty(), "At least one liquidity pool is required" );
+   FC_ASSERT( pools.size() <= GRAPHENE_MAX_LIQUIDITY_POOL_ROUTE_LENGTH,
+              "Can not exchange through more than ${n} liquidity pools", ("n", GRAPHENE_MAX_LIQUIDITY_POOL_ROUTE_LENGTH) );
+   FC_ASSERT( flat_set<liquidity_pool_id_type>( pools.begin(), pools.end() ).size() == pools.size(),
+              "Can not exchange with the same liquidity pool twice" );
+   FC_ASSERT( amount_to_sell.amount > 0, "Amount to sell should be positive" );
+   FC_ASSERT( min_to_receive.amount > 0, "Minimum amount to receive should be positive" );
+   FC_ASSERT( amount_to_sell.asset_id != min_to_receive.asset_id,
+             "ID of the two assets should not be the same" );
+}
+
+share_type liquidity_pool_route_exchange_operation::calculate_fee( const fee_parameters_type& k )const
+{
+   uint64_t hops = ( pools.empty() ? 0 : pools.size() - 1 );
+   // multiply with overflow check
+   uint64_t per_hop_fee = k.price_per_hop * hops;
+   FC_ASSERT( hops == 0 || per_hop_fee / hops == k.price_per_hop, "Fee calculation overflow" );
+   return k.fee + per_hop_fee;
+}
+
 } } // graphene::protocol
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_create_operation::fee_parameters_type )
@@ -72,9 +95,11 @@ GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_de
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_deposit_operation::fee_parameters_type )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_withdraw_operation::fee_parameters_type )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_exchange_operation::fee_parameters_type )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_route_exchange_operation::fee_parameters_type )
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_create_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_delete_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_deposit_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_withdraw_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_exchange_operation )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::liquidity_pool_route_exchange_operation )
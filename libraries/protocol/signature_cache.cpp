@@ -0,0 +1,100 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/protocol/signature_cache.hpp>
+
+#include <cstring>
+
+namespace graphene { namespace protocol {
+
+signature_key_cache& signature_key_cache::instance()
+{
+   static signature_key_cache cache;
+   return cache;
+}
+
+signature_key_cache::signature_key_cache()
+   : _shard_capacity( default_capacity / shard_count ), _hits( 0 ), _misses( 0 )
+{
+}
+
+size_t signature_key_cache::cache_key_hash::operator()( const cache_key& key )const
+{
+   // Both parts are already uniformly distributed
+   uint64_t signature_bits;
+   std::memcpy( &signature_bits, key.signature.data + 1, sizeof( signature_bits ) );
+   return size_t( key.digest._hash[0] ^ signature_bits );
+}
+
+signature_key_cache::shard& signature_key_cache::shard_for( const cache_key& key )
+{
+   return _shards[ cache_key_hash()( key ) % shard_count ];
+}
+
+public_key_type signature_key_cache::recover( const fc::ecc::compact_signature& signature,
+                                              const digest_type& digest )
+{
+   const size_t shard_capacity = _shard_capacity.load( std::memory_order_relaxed );
+   if( shard_capacity == 0 )
+   {
+      _misses.fetch_add( 1, std::memory_order_relaxed );
+      return fc::ecc::public_key( signature, digest );
+   }
+
+   const cache_key key { digest, signature };
+   shard& s = shard_for( key );
+   {
+      std::lock_guard< std::mutex > lock( s.mutex );
+      auto itr = s.keys.find( key );
+      if( itr != s.keys.end() )
+      {
+         _hits.fetch_add( 1, std::memory_order_relaxed );
+         return itr->second;
+      }
+   }
+
+   // Recover without holding the lock, a signature that can not be recovered throws and is not cached
+   _misses.fetch_add( 1, std::memory_order_relaxed );
+   const public_key_type result( fc::ecc::public_key( signature, digest ) );
+
+   std::lock_guard< std::mutex > lock( s.mutex );
+   if( s.keys.emplace( key, result ).second )
+   {
+      s.insertion_order.push_back( key );
+      while( s.insertion_order.size() > shard_capacity )
+      {
+         s.keys.erase( s.insertion_order.front() );
+         s.insertion_order.pop_front();
+      }
+   }
+   return result;
+}
+
+void signature_key_cache::set_capacity( size_t capacity )
+{
+   // Round up, so that a small non-zero capacity does not disable the cache
+   _shard_capacity.store( ( capacity + shard_count - 1 ) / shard_count );
+   for( shard& s : _shards )
+   {
+      std::lock_guard< std::mutex > lock( s.mutex );
+      s.keys.clear();
+      s.insertion_order.clear();
+   }
+}
+
+signature_key_cache_stats signature_key_cache::get_stats()const
+{
+   signature_key_cache_stats result;
+   result.hits = _hits.load( std::memory_order_relaxed );
+   result.misses = _misses.load( std::memory_order_relaxed );
+   result.capacity = _shard_capacity.load( std::memory_order_relaxed ) * shard_count;
+   for( const shard& s : _shards )
+   {
+      std::lock_guard< std::mutex > lock( s.mutex );
+      result.size += s.keys.size();
+   }
+   return result;
+}
+
+} } // graphene::protocol
@@ -27,9 +27,12 @@
 #include <graphene/protocol/exceptions.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
 #include <graphene/protocol/pts_address.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 
 #include <fc/io/raw.hpp>
 
+#include <atomic>
+
 namespace graphene { namespace protocol {
 
 digest_type processed_transaction::merkle_digest()const
@@ -327,7 +330,7 @@ const flat_set<public_key_type>& signed_transaction::get_signature_keys( const c
    for( const auto&  sig : signatures )
    {
       GRAPHENE_ASSERT(
-         result.insert( fc::ecc::public_key(sig,d) ).second,
+         result.insert( signature_key_cache::instance().recover( sig, d ) ).second,
             tx_duplicate_sig,
             "Duplicate Signature detected" );
    }
@@ -414,13 +417,41 @@ void precomputable_transaction::validate() const
    _validated = true;
 }
 
+static std::atomic<uint64_t> packed_sizes_computed( 0 );
+static std::atomic<uint64_t> packed_sizes_reused( 0 );
+
+packed_size_stats get_packed_size_stats()
+{
+   packed_size_stats result;
+   result.computed = packed_sizes_computed.load( std::memory_order_relaxed );
+   result.reused = packed_sizes_reused.load( std::memory_order_relaxed );
+   return result;
+}
+
 uint64_t precomputable_transaction::get_packed_size()const
 {
    if( _packed_size == 0 )
+   {
       _packed_size = transaction::get_packed_size();
+      packed_sizes_computed.fetch_add( 1, std::memory_order_relaxed );
+   }
+   else
+      packed_sizes_reused.fetch_add( 1, std::memory_order_relaxed );
    return _packed_size;
 }
 
+uint64_t processed_transaction::get_serialized_size()const
+{
+   if( _serialized_size == 0 )
+   {
+      _serialized_size = fc::raw::pack_size( *this );
+      packed_sizes_computed.fetch_add( 1, std::memory_order_relaxed );
+   }
+   else
+      packed_sizes_reused.fetch_add( 1, std::memory_order_relaxed );
+   return _serialized_size;
+}
+
 const flat_set<public_key_type>& precomputable_transaction::get_signature_keys( const chain_id_type& chain_id )const
 {
    // Strictly we should check whether the given chain ID is same as the one used to initialize the `signees` field.
@@ -1088,6 +1088,18 @@ class wallet_api
                                           price_ratio usd_price,
                                           bool broadcast = false);
 
+   /**
+    * Publish the USD-prices of several user-issued assets (UIA) in a single operation.
+    *
+    * @param publishing_account the account publishing the price feeds
+    * @param usd_prices the USD-price of each asset, keyed by the asset symbol
+    * @param broadcast true to broadcast the transaction on the network
+    * @returns the signed transaction updating the prices for the UIAs
+    */
+   signed_transaction publish_asset_prices(string publishing_account,
+                                           flat_map<string, price_ratio> usd_prices,
+                                           bool broadcast = false);
+
    /**
     * Get published asset price of an asset
     */
@@ -1885,6 +1897,7 @@ FC_API( graphene::wallet::wallet_api,
         (get_asset_limitaion_by_symbol)
         (get_asset_limitation_value)
         (publish_asset_price)
+        (publish_asset_prices)
         (get_published_asset_price)
         (get_account)
         (get_account_id)
@@ -864,6 +864,14 @@ signed_transaction wallet_api::publish_asset_price(string publishing_account,
 }
 
 
+signed_transaction wallet_api::publish_asset_prices(string publishing_account,
+                                                    flat_map<string, price_ratio> usd_prices,
+                                                    bool broadcast)
+{
+   return my->publish_asset_prices(publishing_account, usd_prices, broadcast);
+}
+
+
 price_ratio wallet_api::get_published_asset_price(const std::string &symbol) const
 {
    return my->get_published_asset_price(symbol);
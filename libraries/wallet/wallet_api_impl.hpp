@@ -430,6 +430,9 @@ public:
                                           string symbol,
                                           price_ratio usd_price,
                                           bool broadcast = false);
+   signed_transaction publish_asset_prices(string publishing_account,
+                                           flat_map<string, price_ratio> usd_prices,
+                                           bool broadcast = false);
    price_ratio get_published_asset_price(const std::string &symbol) const;
 
 
@@ -0,0 +1,249 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+
+#include <graphene/chain/block_database.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/db_with.hpp>
+#include <graphene/chain/genesis_state.hpp>
+#include <graphene/egenesis/egenesis.hpp>
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/json.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <tuple>
+
+using namespace graphene::chain;
+namespace bpo = boost::program_options;
+namespace bfs = boost::filesystem;
+
+namespace {
+
+/// The checks skipped by a node replaying its own block log, see application_impl::startup
+const uint32_t replay_skip_flags = database::skip_witness_signature
+                                 | database::skip_block_size_check
+                                 | database::skip_merkle_check
+                                 | database::skip_transaction_signatures
+                                 | database::skip_transaction_dupe_check
+                                 | database::skip_tapos_check
+                                 | database::skip_witness_schedule_check;
+
+void copy_directory( const bfs::path& from, const bfs::path& to )
+{
+   bfs::create_directories( to );
+   for( bfs::directory_iterator itr( from ), end; itr != end; ++itr )
+   {
+      if( bfs::is_directory( itr->status() ) )
+         copy_directory( itr->path(), to / itr->path().filename() );
+      else
+         bfs::copy_file( itr->path(), to / itr->path().filename() );
+   }
+}
+
+genesis_state_type load_genesis( const bpo::variables_map& options )
+{
+   std::string genesis_json;
+   if( options.count("genesis-json") )
+      fc::read_file_contents( options.at("genesis-json").as<bfs::path>(), genesis_json );
+   else
+      graphene::egenesis::compute_egenesis_json( genesis_json );
+   genesis_state_type genesis = load_genesis_state( fc::json::from_string( genesis_json ), 20 );
+   genesis.initial_chain_id = fc::sha256::hash( genesis_json );
+   return genesis;
+}
+
+double per_second( uint64_t count, const fc::microseconds& elapsed )
+{
+   return double( count ) * 1000000 / std::max<int64_t>( elapsed.count(), 1 );
+}
+
+void print_stats( const std::string& name, const block_phase_stats& stats )
+{
+   std::cout << "  " << std::left << std::setw( 32 ) << name << std::right
+             << std::setw( 12 ) << stats.count
+             << std::setw( 14 ) << std::fixed << std::setprecision( 1 ) << stats.total.count() / 1000.0
+             << std::setw( 12 ) << std::setprecision( 1 ) << double( stats.total.count() ) / std::max<uint64_t>( stats.count, 1 )
+             << std::setw( 12 ) << stats.max.count() << "\n";
+}
+
+void print_stats_header( const std::string& title )
+{
+   std::cout << "\n" << std::left << std::setw( 34 ) << title << std::right
+             << std::setw( 12 ) << "count" << std::setw( 14 ) << "total ms"
+             << std::setw( 12 ) << "mean us" << std::setw( 12 ) << "max us" << "\n";
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      bpo::options_description cli_options("Replay a range of blocks and measure it");
+      cli_options.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("blocks-dir", bpo::value<bfs::path>(),
+             "Directory of the block log to replay, holding the blocks and index files, i.e. "
+             "<data-dir>/blockchain/database/block_num_to_block of a node. It is not modified.")
+            ("snapshot-dir", bpo::value<bfs::path>(),
+             "Directory of the object database to start from, i.e. <data-dir>/blockchain of a node that was stopped. "
+             "It is copied to the work directory and not modified. Replay starts from the genesis if omitted.")
+            ("genesis-json", bpo::value<bfs::path>(),
+             "File to read the genesis state from when there is no snapshot, the embedded genesis if omitted")
+            ("work-dir", bpo::value<bfs::path>(),
+             "Directory to copy the object database to, a temporary directory if omitted")
+            ("last-block", bpo::value<uint32_t>(), "Number of the last block to replay, the last block of the log if omitted")
+            ("skip-flags", bpo::value<uint32_t>()->default_value( replay_skip_flags ),
+             "Checks to skip, a combination of database::validation_steps; the default skips what a node skips when "
+             "it replays its own blocks, 0 validates everything")
+            ("operation-timing", "Also measure the evaluation of every type of operation")
+            ;
+
+      bpo::variables_map options;
+      try
+      {
+         bpo::store( bpo::parse_command_line( argc, argv, cli_options ), options );
+      }
+      catch( const bpo::error& e )
+      {
+         std::cerr << "replay_bench:  error parsing command line: " << e.what() << "\n";
+         return 1;
+      }
+
+      if( options.count("help") )
+      {
+         std::cout << cli_options << "\n";
+         return 1;
+      }
+
+      if( !options.count("blocks-dir") )
+      {
+         std::cerr << "--blocks-dir option is required\n";
+         return 1;
+      }
+
+      std::unique_ptr<fc::temp_directory> temp_dir;
+      fc::path work_dir;
+      if( options.count("work-dir") )
+         work_dir = options.at("work-dir").as<bfs::path>();
+      else
+      {
+         temp_dir.reset( new fc::temp_directory( graphene::utilities::temp_directory_path() ) );
+         work_dir = temp_dir->path();
+      }
+      FC_ASSERT( !fc::exists( work_dir / "object_database" ), "The work directory already holds an object database" );
+      if( options.count("snapshot-dir") )
+      {
+         const bfs::path snapshot_dir = options.at("snapshot-dir").as<bfs::path>();
+         std::cerr << "replay_bench:  Copying the object database of " << snapshot_dir.string() << "\n";
+         bfs::copy_file( snapshot_dir / "db_version", bfs::path( work_dir.string() ) / "db_version" );
+         copy_directory( snapshot_dir / "object_database", bfs::path( work_dir.string() ) / "object_database" );
+      }
+
+      block_database blocks;
+      blocks.open( options.at("blocks-dir").as<bfs::path>() );
+      const fc::optional<signed_block> last_in_log = blocks.last();
+      FC_ASSERT( last_in_log.valid(), "The block log is empty" );
+
+      const uint32_t skip = options.at("skip-flags").as<uint32_t>();
+
+      // The work directory has no block log, so that opening the database does not replay anything
+      database db;
+      detail::with_skip_flags( db, skip, [&db,&work_dir,&options] () {
+         db.open( work_dir, [&options] { return load_genesis( options ); }, GRAPHENE_CURRENT_DB_VERSION );
+      });
+      if( options.count("operation-timing") )
+         db.set_operation_timing_enabled( true );
+      db._undo_db.disable();
+
+      const uint32_t first_block = db.head_block_num() + 1;
+      const uint32_t last_block = options.count("last-block") ? options.at("last-block").as<uint32_t>()
+                                                              : last_in_log->block_num();
+      FC_ASSERT( first_block <= last_block, "Nothing to replay, the object database is at block ${n}",
+                 ("n", db.head_block_num()) );
+      FC_ASSERT( last_block <= last_in_log->block_num(), "The block log ends at block ${n}",
+                 ("n", last_in_log->block_num()) );
+      std::cerr << "replay_bench:  Replaying blocks " << first_block << " to " << last_block << "\n";
+
+      // Blocks are read and their signatures recovered ahead of their application, as in database::reindex
+      std::queue< std::tuple< signed_block, fc::future<void> > > pending;
+      uint32_t next_to_read = first_block;
+      uint64_t transaction_count = 0;
+      uint64_t operation_count = 0;
+      const fc::time_point start = fc::time_point::now();
+      for( uint32_t next_to_apply = first_block; next_to_apply <= last_block; )
+      {
+         if( next_to_read <= last_block && pending.size() < 20 )
+         {
+            fc::optional<signed_block> block = blocks.fetch_by_number( next_to_read );
+            FC_ASSERT( block.valid(), "Block ${n} is missing from the block log", ("n", next_to_read) );
+            pending.emplace( std::move( *block ), fc::future<void>() );
+            std::get<1>( pending.back() ) = db.precompute_parallel( std::get<0>( pending.back() ), skip );
+            ++next_to_read;
+            continue;
+         }
+
+         std::get<1>( pending.front() ).wait();
+         const signed_block& block = std::get<0>( pending.front() );
+         FC_ASSERT( block.previous == db.head_block_id(), "Block ${n} does not follow the object database",
+                    ("n", next_to_apply) );
+         db.apply_block( block, skip );
+         transaction_count += block.transactions.size();
+         for( const auto& trx : block.transactions )
+            operation_count += trx.operations.size();
+         pending.pop();
+
+         if( next_to_apply % 10000 == 0 )
+            std::cerr << "replay_bench:  Applied block " << next_to_apply << "\n";
+         ++next_to_apply;
+      }
+      const fc::microseconds elapsed = fc::time_point::now() - start;
+
+      const uint64_t block_count = last_block - first_block + 1;
+      std::cout << "Replayed " << block_count << " blocks, " << transaction_count << " transactions and "
+                << operation_count << " operations in " << std::fixed << std::setprecision( 3 )
+                << elapsed.count() / 1000000.0 << " s with skip flags 0x" << std::hex << skip << std::dec << "\n"
+                << std::setprecision( 1 )
+                << "  " << per_second( block_count, elapsed ) << " blocks/s, "
+                << per_second( transaction_count, elapsed ) << " transactions/s, "
+                << per_second( operation_count, elapsed ) << " operations/s\n";
+
+      print_stats_header( "Step" );
+      const auto& phase_stats = db.get_block_phase_stats();
+      for( size_t i = 0; i < block_phase_count; ++i )
+      {
+         if( phase_stats[i].count > 0 )
+            print_stats( fc::reflector<block_phase>::to_string( block_phase( i ) ), phase_stats[i] );
+      }
+
+      const auto& operation_stats = db.get_operation_timing_stats();
+      if( !operation_stats.empty() )
+      {
+         print_stats_header( "Operation" );
+         for( size_t i = 0; i < operation_stats.size(); ++i )
+         {
+            if( operation_stats[i].evaluate.count == 0 )
+               continue;
+            const std::string name = operation_type_name( i );
+            print_stats( name + " evaluate", operation_stats[i].evaluate );
+            print_stats( name + " apply", operation_stats[i].apply );
+         }
+      }
+
+      // The copy of the object database is discarded, it is not saved
+   }
+   catch( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+   return 0;
+}
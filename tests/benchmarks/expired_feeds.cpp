@@ -0,0 +1,78 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/asset_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( expired_feeds_bench, database_fixture )
+
+/**
+ * Measure the per-block cost of the feed expiration and core exchange rate steps with a large number of
+ * bitassets, of which only a few have their feed expiring in each block
+ */
+BOOST_AUTO_TEST_CASE( expired_feeds_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t bitasset_count = 100000;
+      const uint32_t block_count = 2000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t bitasset_count = 5000;
+      const uint32_t block_count = 200;
+#endif
+      db._undo_db.disable();
+
+      // Spread the feed expirations evenly over one feed lifetime
+      const uint32_t feed_lifetime = GRAPHENE_DEFAULT_PRICE_FEED_LIFETIME;
+      const time_point_sec now = db.head_block_time();
+      for( uint32_t i = 0; i < bitasset_count; ++i )
+      {
+         const asset_id_type asset_id = db.get_index_type<asset_index>().get_next_id();
+         const auto& dyn = db.create<asset_dynamic_data_object>( []( asset_dynamic_data_object& ){} );
+         const auto& bad = db.create<asset_bitasset_data_object>( [&]( asset_bitasset_data_object& b ) {
+            b.asset_id = asset_id;
+            b.options.feed_lifetime_sec = feed_lifetime;
+            b.current_feed_publication_time = now - feed_lifetime + uint32_t( uint64_t(i) * feed_lifetime / bitasset_count );
+         });
+         db.create<asset_object>( [&]( asset_object& a ) {
+            a.symbol = "BENCH" + fc::to_string( i );
+            a.issuer = GRAPHENE_COMMITTEE_ACCOUNT;
+            a.options.core_exchange_rate = price( asset( 1, asset_id ), asset( 1 ) );
+            a.dynamic_asset_data_id = dyn.id;
+            a.bitasset_data_id = bad.id;
+         });
+      }
+
+      const size_t feeds_phase = size_t( block_phase::expired_feeds );
+      const size_t cer_phase = size_t( block_phase::core_exchange_rates );
+      const block_phase_stats feeds_before = db.get_block_phase_stats()[feeds_phase];
+      const block_phase_stats cer_before = db.get_block_phase_stats()[cer_phase];
+
+      generate_blocks( block_count );
+
+      const block_phase_stats& feeds_after = db.get_block_phase_stats()[feeds_phase];
+      const block_phase_stats& cer_after = db.get_block_phase_stats()[cer_phase];
+      BOOST_REQUIRE_EQUAL( feeds_after.count - feeds_before.count, block_count );
+      BOOST_REQUIRE_EQUAL( cer_after.count - cer_before.count, block_count );
+
+      ilog( "${n} bitassets: expired feeds ${f} us, core exchange rates ${c} us on average per block",
+            ("n", bitasset_count)
+            ("f", ( feeds_after.total - feeds_before.total ).count() / block_count)
+            ("c", ( cer_after.total - cer_before.total ).count() / block_count) );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
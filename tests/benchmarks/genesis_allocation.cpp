@@ -26,6 +26,8 @@
 #include <graphene/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/io/json.hpp>
+#include <fc/thread/parallel.hpp>
 
 #include <boost/test/auto_unit_test.hpp>
 
@@ -59,27 +61,66 @@ BOOST_AUTO_TEST_CASE( genesis_and_persistence_bench )
       const int blocks_to_produce = 1000;
 #endif
 
-      for( int i = 0; i < account_count; ++i )
-         genesis_state.initial_accounts.emplace_back("target"+fc::to_string(i),
-                                                     public_key_type(fc::ecc::private_key::regenerate(fc::digest(i)).get_public_key()));
+      fc::time_point start_time = fc::time_point::now();
+      genesis_state.initial_accounts.resize( account_count );
+      {
+         const int chunk_size = 10000;
+         std::vector<fc::future<void>> workers;
+         for( int base = 0; base < account_count; base += chunk_size )
+            workers.push_back( fc::do_parallel( [&genesis_state,base,chunk_size,account_count] () {
+               for( int i = base; i < std::min( base + chunk_size, account_count ); ++i )
+                  genesis_state.initial_accounts[i] = genesis_state_type::initial_account_type( "target"+fc::to_string(i),
+                        public_key_type(fc::ecc::private_key::regenerate(fc::digest(i)).get_public_key()) );
+            }) );
+         for( auto& worker : workers )
+            worker.wait();
+      }
+      ilog("Derived ${n} account keys in ${t} milliseconds.",
+           ("n", account_count)("t", (fc::time_point::now() - start_time).count() / 1000));
+
+      {
+         start_time = fc::time_point::now();
+         const std::string genesis_json = fc::json::to_string( genesis_state );
+         ilog("Serialized genesis to ${b} bytes of JSON in ${t} milliseconds.",
+              ("b", genesis_json.size())("t", (fc::time_point::now() - start_time).count() / 1000));
+
+         start_time = fc::time_point::now();
+         const fc::variant genesis_var = fc::json::from_string( genesis_json );
+         ilog("Parsed genesis JSON in ${t} milliseconds.", ("t", (fc::time_point::now() - start_time).count() / 1000));
+
+         start_time = fc::time_point::now();
+         const genesis_state_type sequential = genesis_var.as<genesis_state_type>( 20 );
+         ilog("Converted genesis on one thread in ${t} milliseconds.",
+              ("t", (fc::time_point::now() - start_time).count() / 1000));
+
+         start_time = fc::time_point::now();
+         const genesis_state_type chunked = load_genesis_state( genesis_var, 20 );
+         ilog("Converted genesis in parallel chunks in ${t} milliseconds.",
+              ("t", (fc::time_point::now() - start_time).count() / 1000));
+
+         BOOST_CHECK( fc::json::to_string( chunked ) == fc::json::to_string( sequential ) );
+      }
 
       fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
 
       {
          database db;
+         start_time = fc::time_point::now();
          db.open(data_dir.path(), [&]{return genesis_state;}, "test");
+         ilog("Initialized database from genesis in ${t} milliseconds.",
+              ("t", (fc::time_point::now() - start_time).count() / 1000));
 
          for( int i = 11; i < account_count + 11; ++i)
             BOOST_CHECK(db.get_balance(account_id_type(i), asset_id_type()).amount == GRAPHENE_MAX_SHARE_SUPPLY / account_count);
 
-         fc::time_point start_time = fc::time_point::now();
+         start_time = fc::time_point::now();
          db.close();
          ilog("Closed database in ${t} milliseconds.", ("t", (fc::time_point::now() - start_time).count() / 1000));
       }
       {
          database db;
 
-         fc::time_point start_time = fc::time_point::now();
+         start_time = fc::time_point::now();
          db.open(data_dir.path(), [&]{return genesis_state;}, "test");
          ilog("Opened database in ${t} milliseconds.", ("t", (fc::time_point::now() - start_time).count() / 1000));
 
@@ -113,7 +154,7 @@ BOOST_AUTO_TEST_CASE( genesis_and_persistence_bench )
       {
          database db;
 
-         auto start_time = fc::time_point::now();
+         start_time = fc::time_point::now();
          wlog( "about to start reindex..." );
          db.open(data_dir.path(), [&]{return genesis_state;}, "force_wipe");
          ilog("Replayed database in ${t} milliseconds.", ("t", (fc::time_point::now() - start_time).count() / 1000));
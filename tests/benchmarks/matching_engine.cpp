@@ -0,0 +1,324 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/market_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+#include <numeric>
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+const uint32_t bench_skip = database::skip_transaction_signatures | database::skip_tapos_check
+                          | database::skip_transaction_dupe_check;
+
+uint64_t per_second( uint64_t count, const fc::microseconds& elapsed )
+{
+   return count * 1000000 / std::max<int64_t>( elapsed.count(), 1 );
+}
+
+struct matching_engine_bench_fixture : database_fixture
+{
+   /// Number of fill_order_operation applied since the applied operations held @p from entries
+   uint64_t count_fills( size_t from )const
+   {
+      const auto& ops = db.get_applied_operations();
+      uint64_t fills = 0;
+      for( size_t i = from; i < ops.size(); ++i )
+      {
+         if( ops[i].valid() && ops[i]->op.is_type<fill_order_operation>() )
+            ++fills;
+      }
+      return fills;
+   }
+
+   void apply( const operation& op )
+   {
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+      db.apply_transaction( tx, bench_skip );
+   }
+
+   /// Generate the first block at or after @p when, skipping the slots before it
+   void generate_block_at( fc::time_point_sec when )
+   {
+      const uint32_t interval = db.get_global_properties().parameters.block_interval;
+      const uint32_t slots = ( when - db.head_block_time() ).to_seconds() / interval;
+      generate_block( ~0, init_account_priv_key, slots > 0 ? slots - 1 : 0 );
+      BOOST_REQUIRE( db.head_block_time() >= when );
+   }
+
+   /// Advance past the hard forks changing the matching of call orders, to the first maintenance after them
+   void advance_past_market_hardforks()
+   {
+      generate_blocks( HARDFORK_CORE_1270_TIME );
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+      set_expiration( db, trx );
+   }
+
+   /**
+    * Create @p count borrowers of @p mia, each borrowing 1000 units at 300% collateral under a feed of 1/5
+    * @return the borrowers
+    */
+   vector<account_id_type> create_borrowers( const asset_object& mia, uint32_t count )
+   {
+      vector<account_id_type> borrowers;
+      borrowers.reserve( count );
+      for( uint32_t i = 0; i < count; ++i )
+      {
+         const account_id_type id = create_account( "borrower" + fc::to_string( i ) ).id;
+         transfer( committee_account, id, asset( 100000 ) );
+         borrow( id, mia.amount( 1000 ), asset( 15000 ) );
+         borrowers.push_back( id );
+      }
+      return borrowers;
+   }
+};
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( matching_engine_bench, matching_engine_bench_fixture )
+
+/**
+ * Measure apply_order, match and fill_limit_order across book depths: placing orders on a book of distinct prices,
+ * takers filling the best order one at a time, and a taker sweeping the rest of the book
+ */
+BOOST_AUTO_TEST_CASE( limit_order_depth_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const vector<uint32_t> depths = { 100, 1000, 10000, 100000 };
+#else
+      ilog("Running in debug mode.");
+      const vector<uint32_t> depths = { 100, 1000 };
+#endif
+      const account_id_type maker_id = create_account( "maker" ).id;
+      const account_id_type taker_id = create_account( "taker" ).id;
+      const int64_t total_depth = std::accumulate( depths.begin(), depths.end(), int64_t( 0 ) );
+      transfer( committee_account, maker_id, asset( total_depth * 100 ) );
+      db._undo_db.disable();
+
+      for( size_t d = 0; d < depths.size(); ++d )
+      {
+         const uint32_t depth = depths[d];
+         const asset_id_type usd_id = create_user_issued_asset( "BOOK" + string( 1, char( 'A' + d ) ) ).id;
+         issue_uia( taker_id, asset( int64_t( depth ) * ( 200 + depth ), usd_id ) );
+
+         // The best bid sells 100 CORE for 200 units, every following bid asks for one more unit
+         limit_order_create_operation op;
+         op.seller = maker_id;
+         op.amount_to_sell = asset( 100 );
+         auto start = fc::time_point::now();
+         for( uint32_t i = 0; i < depth; ++i )
+         {
+            op.min_to_receive = asset( 200 + i, usd_id );
+            apply( op );
+         }
+         auto elapsed = fc::time_point::now() - start;
+         ilog( "Depth ${d}: placed ${n} orders in ${t} us, ${r} orders/s.",
+               ("d", depth)("n", depth)("t", elapsed.count())("r", per_second( depth, elapsed )) );
+
+         // Takers filling the best bid exactly, half of the book
+         const uint32_t taker_count = depth / 2;
+         op.seller = taker_id;
+         op.min_to_receive = asset( 100 );
+         size_t mark = db.get_applied_operations().size();
+         start = fc::time_point::now();
+         for( uint32_t i = 0; i < taker_count; ++i )
+         {
+            op.amount_to_sell = asset( 200 + i, usd_id );
+            apply( op );
+         }
+         elapsed = fc::time_point::now() - start;
+         uint64_t fills = count_fills( mark );
+         ilog( "Depth ${d}: matched ${n} takers with ${f} fills in ${t} us, ${r} orders/s, ${s} fills/s.",
+               ("d", depth)("n", taker_count)("f", fills)("t", elapsed.count())
+               ("r", per_second( taker_count, elapsed ))("s", per_second( fills, elapsed )) );
+         BOOST_CHECK_EQUAL( fills, 2 * taker_count );
+
+         // A single taker sweeping the other half
+         int64_t remaining = 0;
+         for( uint32_t i = taker_count; i < depth; ++i )
+            remaining += 200 + i;
+         op.amount_to_sell = asset( remaining, usd_id );
+         op.min_to_receive = asset( remaining * 100 / ( 200 + depth ) );
+         mark = db.get_applied_operations().size();
+         start = fc::time_point::now();
+         apply( op );
+         elapsed = fc::time_point::now() - start;
+         fills = count_fills( mark );
+         ilog( "Depth ${d}: swept ${n} orders with ${f} fills in ${t} us, ${s} fills/s.",
+               ("d", depth)("n", depth - taker_count)("f", fills)("t", elapsed.count())
+               ("s", per_second( fills, elapsed )) );
+         BOOST_CHECK_EQUAL( fills, 2 * ( depth - taker_count ) );
+         BOOST_CHECK( db.get_index_type<limit_order_index>().indices().empty() );
+      }
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+/**
+ * Measure check_call_orders and fill_call_order when a drop of the feed puts every call order under its
+ * maintenance collateral ratio, each of them being covered by a limit order
+ */
+BOOST_AUTO_TEST_CASE( margin_call_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t call_count = 10000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t call_count = 200;
+#endif
+      advance_past_market_hardforks();
+      ACTORS( (feedproducer) );
+      const asset_object& bitusd = create_bitasset( "USDBIT", feedproducer_id );
+      const asset_id_type usd_id = bitusd.id;
+      update_feed_producers( bitusd, { feedproducer_id } );
+      price_feed feed;
+      feed.maintenance_collateral_ratio = 1750;
+      feed.maximum_short_squeeze_ratio = 1100;
+      feed.settlement_price = bitusd.amount( 1 ) / asset( 5 );
+      publish_feed( bitusd, feedproducer_id( db ), feed );
+
+      const vector<account_id_type> borrowers = create_borrowers( usd_id( db ), call_count );
+      db._undo_db.disable();
+
+      // Every borrower offers its debt at 10.5 CORE, below the squeeze price of 11 CORE after the drop
+      for( const account_id_type id : borrowers )
+         create_sell_order( id, asset( 1000, usd_id ), asset( 10500 ) );
+
+      // At 1/10, the collateral ratio of every call order is 150%
+      feed.settlement_price = usd_id( db ).amount( 1 ) / asset( 10 );
+      const size_t mark = db.get_applied_operations().size();
+      const auto start = fc::time_point::now();
+      publish_feed( usd_id( db ), feedproducer_id( db ), feed );
+      const auto elapsed = fc::time_point::now() - start;
+      const uint64_t fills = count_fills( mark );
+      ilog( "Margin called ${n} call orders with ${f} fills in ${t} us, ${r} calls/s, ${s} fills/s.",
+            ("n", call_count)("f", fills)("t", elapsed.count())
+            ("r", per_second( call_count, elapsed ))("s", per_second( fills, elapsed )) );
+
+      BOOST_CHECK( db.get_index_type<call_order_index>().indices().empty() );
+      BOOST_CHECK_EQUAL( fills, 2 * call_count );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+/**
+ * Measure the execution of force settlements by clear_expired_orders, each settling against the least collateralized
+ * call order. The undo history is kept, as in a node applying the block.
+ */
+BOOST_AUTO_TEST_CASE( force_settlement_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t settle_count = 10000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t settle_count = 200;
+#endif
+      advance_past_market_hardforks();
+      ACTORS( (feedproducer) );
+      const asset_object& bitusd = create_bitasset( "USDBIT", feedproducer_id );
+      const asset_id_type usd_id = bitusd.id;
+      update_feed_producers( bitusd, { feedproducer_id } );
+      price_feed feed;
+      feed.maintenance_collateral_ratio = 1750;
+      feed.maximum_short_squeeze_ratio = 1100;
+      feed.settlement_price = bitusd.amount( 1 ) / asset( 5 );
+      publish_feed( bitusd, feedproducer_id( db ), feed );
+
+      // Each borrower settles 1% of its debt, within the maximum settlement volume of the interval
+      const vector<account_id_type> borrowers = create_borrowers( usd_id( db ), settle_count );
+      for( const account_id_type id : borrowers )
+         force_settle( id, asset( 10, usd_id ) );
+
+      const auto& settlements = db.get_index_type<force_settlement_index>().indices().get<by_expiration>();
+      const fc::time_point_sec settlement_date = settlements.rbegin()->settlement_date;
+      generate_blocks( settlement_date - fc::minutes( 10 ) );
+      // The feed must still be valid when the settlements are executed
+      set_expiration( db, trx );
+      publish_feed( usd_id( db ), feedproducer_id( db ), feed );
+
+      const auto start = fc::time_point::now();
+      generate_block_at( settlement_date );
+      const auto elapsed = fc::time_point::now() - start;
+      ilog( "Executed ${n} force settlements in a block of ${t} us, ${r} settlements/s.",
+            ("n", settle_count)("t", elapsed.count())("r", per_second( settle_count, elapsed )) );
+
+      BOOST_CHECK( db.get_index_type<force_settlement_index>().indices().empty() );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+/**
+ * Measure the cancellation of expired limit orders by clear_expired_orders
+ */
+BOOST_AUTO_TEST_CASE( expired_orders_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t order_count = 200000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t order_count = 10000;
+#endif
+      const account_id_type maker_id = create_account( "maker" ).id;
+      const asset_id_type usd_id = create_user_issued_asset( "MYUSD" ).id;
+      transfer( committee_account, maker_id, asset( int64_t( order_count ) * 100 ) );
+      // The orders are applied outside of the pending transactions, which must be in a block first
+      generate_block();
+      db._undo_db.disable();
+
+      const fc::time_point_sec expiration = db.head_block_time() + fc::hours( 1 );
+      limit_order_create_operation op;
+      op.seller = maker_id;
+      op.amount_to_sell = asset( 100 );
+      op.expiration = expiration;
+      for( uint32_t i = 0; i < order_count; ++i )
+      {
+         op.min_to_receive = asset( 200 + i % 1000, usd_id );
+         apply( op );
+      }
+      generate_block();
+
+      const auto start = fc::time_point::now();
+      generate_block_at( expiration );
+      const auto elapsed = fc::time_point::now() - start;
+      ilog( "Cancelled ${n} expired orders in a block of ${t} us, ${r} orders/s.",
+            ("n", order_count)("t", elapsed.count())("r", per_second( order_count, elapsed )) );
+
+      BOOST_CHECK( db.get_index_type<limit_order_index>().indices().empty() );
+      BOOST_CHECK_EQUAL( get_balance( maker_id, asset_id_type() ), int64_t( order_count ) * 100 );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
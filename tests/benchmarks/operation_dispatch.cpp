@@ -0,0 +1,66 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( operation_dispatch_bench, database_fixture )
+
+/**
+ * Measure the rate at which cheap operations are evaluated and applied, where the cost of dispatching each
+ * operation to its evaluator is most visible
+ */
+BOOST_AUTO_TEST_CASE( transfer_apply_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t transfer_count = 200000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t transfer_count = 10000;
+#endif
+      const uint32_t transfers_per_trx = 100;
+
+      ACTORS( (alice)(bob) );
+      transfer( committee_account, alice_id, asset( transfer_count ) );
+
+      const uint32_t skip = database::skip_transaction_signatures | database::skip_tapos_check
+                          | database::skip_transaction_dupe_check;
+
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset( 1 );
+
+      signed_transaction tx;
+      for( uint32_t i = 0; i < transfers_per_trx; ++i )
+         tx.operations.push_back( op );
+      set_expiration( db, tx );
+
+      db._undo_db.disable();
+      const auto start = fc::time_point::now();
+      for( uint32_t done = 0; done < transfer_count; done += transfers_per_trx )
+         db.apply_transaction( tx, skip );
+      const auto elapsed = fc::time_point::now() - start;
+
+      ilog( "Applied ${n} transfers in ${t} milliseconds, ${r} per second.",
+            ("n", transfer_count)("t", elapsed.count() / 1000)
+            ("r", uint64_t(transfer_count) * 1000000 / std::max<int64_t>( elapsed.count(), 1 )) );
+
+      BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), transfer_count );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <graphene/app/database_api.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/market_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+const uint32_t bench_skip = database::skip_transaction_signatures | database::skip_tapos_check
+                          | database::skip_transaction_dupe_check;
+
+struct order_book_bench_fixture : database_fixture
+{
+   account_id_type maker_id;
+   account_id_type taker_id;
+   asset_id_type   usd_id;
+
+#ifdef NDEBUG
+   const uint32_t level_count = 100;
+   const uint32_t orders_per_level = 1000;
+#else
+   const uint32_t level_count = 20;
+   const uint32_t orders_per_level = 100;
+#endif
+
+   /// Fill one side of the MYUSD:CORE market with many small bids per price level, the best level first
+   void place_makers()
+   {
+      maker_id = create_account( "maker" ).id;
+      taker_id = create_account( "taker" ).id;
+      usd_id = create_user_issued_asset( "MYUSD" ).id;
+      transfer( committee_account, maker_id, asset( uint64_t( level_count ) * orders_per_level * 100 ) );
+      issue_uia( taker_id, asset( int64_t( level_count ) * orders_per_level * ( 200 + level_count ), usd_id ) );
+      db._undo_db.disable();
+
+      limit_order_create_operation op;
+      op.seller = maker_id;
+      op.amount_to_sell = asset( 100 );
+      signed_transaction tx;
+      set_expiration( db, tx );
+
+      const auto start = fc::time_point::now();
+      for( uint32_t level = 0; level < level_count; ++level )
+      {
+         op.min_to_receive = asset( 200 + level, usd_id );
+         tx.operations = { op };
+         for( uint32_t i = 0; i < orders_per_level; ++i )
+            db.apply_transaction( tx, bench_skip );
+      }
+      const auto elapsed = fc::time_point::now() - start;
+      const uint64_t order_count = uint64_t( level_count ) * orders_per_level;
+      ilog( "Placed ${n} orders at ${l} price levels in ${t} milliseconds, ${r} per second.",
+            ("n", order_count)("l", level_count)("t", elapsed.count() / 1000)
+            ("r", order_count * 1000000 / std::max<int64_t>( elapsed.count(), 1 )) );
+   }
+};
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( order_book_bench, order_book_bench_fixture )
+
+/**
+ * Measure the matching of a taker consuming every level of a book made of many small orders
+ */
+BOOST_AUTO_TEST_CASE( sweep_price_levels_bench )
+{
+   try {
+      place_makers();
+
+      int64_t usd_needed = 0;
+      for( uint32_t level = 0; level < level_count; ++level )
+         usd_needed += int64_t( 200 + level ) * orders_per_level;
+
+      limit_order_create_operation op;
+      op.seller = taker_id;
+      op.amount_to_sell = asset( usd_needed, usd_id );
+      op.min_to_receive = asset( usd_needed * 100 / ( 200 + level_count ) );
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+
+      const auto start = fc::time_point::now();
+      db.apply_transaction( tx, bench_skip );
+      const auto elapsed = fc::time_point::now() - start;
+
+      const uint64_t order_count = uint64_t( level_count ) * orders_per_level;
+      ilog( "Filled ${n} orders in ${t} milliseconds, ${r} fills per second.",
+            ("n", order_count)("t", elapsed.count() / 1000)
+            ("r", order_count * 1000000 / std::max<int64_t>( elapsed.count(), 1 )) );
+
+      BOOST_CHECK( db.get_index_type<limit_order_index>().indices().empty() );
+      BOOST_CHECK_EQUAL( get_balance( maker_id, usd_id ), usd_needed );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+/**
+ * Compare reading the top of the book order by order with reading it level by level
+ */
+BOOST_AUTO_TEST_CASE( order_book_read_bench )
+{
+   try {
+      place_makers();
+
+      graphene::app::application_options opt = app.get_options();
+      graphene::app::database_api db_api( db, &opt );
+      const uint32_t read_count = 1000;
+
+      auto start = fc::time_point::now();
+      size_t entries = 0;
+      for( uint32_t i = 0; i < read_count; ++i )
+         entries = db_api.get_order_book( GRAPHENE_SYMBOL, "MYUSD", 50 ).bids.size();
+      auto elapsed = fc::time_point::now() - start;
+      ilog( "Read ${e} orders of the book ${n} times in ${t} milliseconds.",
+            ("e", entries)("n", read_count)("t", elapsed.count() / 1000) );
+
+      start = fc::time_point::now();
+      for( uint32_t i = 0; i < read_count; ++i )
+         entries = db_api.get_aggregated_order_book( GRAPHENE_SYMBOL, "MYUSD", 50 ).bids.size();
+      elapsed = fc::time_point::now() - start;
+      ilog( "Read ${e} price levels of the book ${n} times in ${t} milliseconds.",
+            ("e", entries)("n", read_count)("t", elapsed.count() / 1000) );
+
+      BOOST_CHECK_EQUAL( entries, std::min<size_t>( level_count, 50 ) );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/top_holders_index.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( top_holders_bench, database_fixture )
+
+/**
+ * Measure the maintenance of a top holders special authority over a widely held asset,
+ * and the cost of keeping its largest holders while the balances change
+ */
+BOOST_AUTO_TEST_CASE( top_holders_authority_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t holder_count = 1000000;
+      const uint32_t transfer_count = 1000000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t holder_count = 20000;
+      const uint32_t transfer_count = 20000;
+#endif
+      ACTORS( (izzy)(stan) );
+      generate_blocks( HARDFORK_516_TIME );
+
+      const asset_id_type topn_id = create_user_issued_asset( "TOPN", izzy_id(db), 0 ).id;
+      {
+         top_holders_special_authority top;
+         top.num_top_holders = 10;
+         top.asset = topn_id;
+
+         account_update_operation op;
+         op.account = stan_id;
+         op.extensions.value.active_special_authority = top;
+         trx.operations.push_back( op );
+         set_expiration( db, trx );
+         sign( trx, stan_private_key );
+         PUSH_TX( db, trx );
+         trx.clear();
+      }
+      db._undo_db.disable();
+
+      auto start_time = fc::time_point::now();
+      vector<account_id_type> holders;
+      holders.reserve( holder_count );
+      share_type supply = 0;
+      for( uint32_t i = 0; i < holder_count; ++i )
+      {
+         const account_object& holder = db.create<account_object>( [this,i]( account_object& obj ) {
+            obj.registrar = GRAPHENE_COMMITTEE_ACCOUNT;
+            obj.referrer = GRAPHENE_COMMITTEE_ACCOUNT;
+            obj.lifetime_referrer = GRAPHENE_COMMITTEE_ACCOUNT;
+            obj.name = "holder" + fc::to_string( i );
+            obj.statistics = db.create<account_statistics_object>( [&obj]( account_statistics_object& s ) {
+               s.owner = obj.id;
+               s.name = obj.name;
+            }).id;
+         });
+         holders.push_back( holder.id );
+         db.adjust_balance( holder.id, asset( 1000 + i, topn_id ) );
+         supply += 1000 + i;
+      }
+      db.modify( topn_id(db).dynamic_asset_data_id(db), [supply]( asset_dynamic_data_object& dd ) {
+         dd.current_supply += supply;
+      });
+      ilog( "Created ${c} holders in ${t} milliseconds.",
+            ("c", holder_count)("t", (fc::time_point::now() - start_time).count() / 1000) );
+
+      const auto& holders_idx = dynamic_cast<const base_primary_index&>( db.get_index_type<account_balance_index>() )
+                                   .get_secondary_index<top_holders_index>();
+      auto measure_maintenance = [&]( const string& label ) {
+         const auto start = fc::time_point::now();
+         generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+         ilog( "${l}: maintenance in ${t} milliseconds, ${n} lookups of the holders.",
+               ("l", label)("t", (fc::time_point::now() - start).count() / 1000)("n", holders_idx.get_lookups()) );
+      };
+
+      measure_maintenance( "Holders looked up" );
+      const authority active_before = stan_id(db).active;
+
+      // the small holders trade among themselves, the largest holders are not disturbed
+      start_time = fc::time_point::now();
+      const uint32_t small_holders = holder_count / 2;
+      for( uint32_t i = 0; i < transfer_count; ++i )
+      {
+         const account_id_type from = holders[ i % small_holders ];
+         const account_id_type to = holders[ ( i * 7 + 1 ) % small_holders ];
+         db.adjust_balance( from, -asset( 1, topn_id ) );
+         db.adjust_balance( to, asset( 1, topn_id ) );
+      }
+      ilog( "Applied ${c} balance transfers in ${t} milliseconds.",
+            ("c", transfer_count)("t", (fc::time_point::now() - start_time).count() / 1000) );
+
+      measure_maintenance( "Holders kept" );
+      BOOST_CHECK( stan_id(db).active == active_before );
+      BOOST_CHECK_EQUAL( holders_idx.get_lookups(), 1u );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
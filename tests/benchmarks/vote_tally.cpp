@@ -0,0 +1,81 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/witness_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( vote_tally_bench, database_fixture )
+
+/**
+ * Measure the maintenance block with a large number of voting accounts,
+ * with the sequential tally before the hard fork, and the running tally after it
+ */
+BOOST_AUTO_TEST_CASE( maintenance_vote_tally_bench )
+{
+   try {
+#ifdef NDEBUG
+      ilog("Running in release mode.");
+      const uint32_t account_count = 2000000;
+#else
+      ilog("Running in debug mode.");
+      const uint32_t account_count = 50000;
+#endif
+      db._undo_db.disable();
+
+      const witness_object& wit = *db.get_index_type<witness_index>().indices().begin();
+      const vote_id_type vote = wit.vote_id;
+
+      auto start_time = fc::time_point::now();
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         db.create<account_object>( [this,i,vote]( account_object& obj ) {
+            obj.registrar = GRAPHENE_COMMITTEE_ACCOUNT;
+            obj.referrer = GRAPHENE_COMMITTEE_ACCOUNT;
+            obj.lifetime_referrer = GRAPHENE_COMMITTEE_ACCOUNT;
+            obj.name = "voter" + fc::to_string( i );
+            obj.options.votes.insert( vote );
+            obj.statistics = db.create<account_statistics_object>( [&obj]( account_statistics_object& s ) {
+               s.owner = obj.id;
+               s.name = obj.name;
+               s.is_voting = true;
+               s.core_in_balance = 1000;
+            }).id;
+         });
+      }
+      ilog( "Created ${c} voting accounts in ${t} milliseconds.",
+            ("c", account_count)("t", (fc::time_point::now() - start_time).count() / 1000) );
+
+      auto measure_maintenance = [this,&wit]( const string& label ) -> uint64_t {
+         const auto start = fc::time_point::now();
+         generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+         ilog( "${l}: maintenance in ${t} milliseconds.",
+               ("l", label)("t", (fc::time_point::now() - start).count() / 1000) );
+         return wit.total_votes;
+      };
+
+      const uint64_t sequential_votes = measure_maintenance( "Sequential tally" );
+
+      generate_blocks( HARDFORK_VOTE_TALLY_SNAPSHOT_TIME );
+      const uint64_t rebuilt_votes = measure_maintenance( "Running tally built" );
+      const uint64_t running_votes = measure_maintenance( "Running tally updated" );
+
+      BOOST_CHECK_GE( sequential_votes, uint64_t(account_count) * 1000 );
+      BOOST_CHECK_GE( rebuilt_votes, uint64_t(account_count) * 1000 );
+      BOOST_CHECK_EQUAL( running_votes, rebuilt_votes );
+
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
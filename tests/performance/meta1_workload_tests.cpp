@@ -0,0 +1,394 @@
+/*
+ * Copyright META1 (c) 2020-2021
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/htlc_object.hpp>
+#include <graphene/chain/liquidity_pool_object.hpp>
+#include <graphene/chain/market_object.hpp>
+
+#include "../common/meta1_fixture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <random>
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+/// The kinds of transactions generated by the workload
+enum workload_kind
+{
+   transfer_kind,
+   limit_order_kind,
+   price_publication_kind,
+   property_kind,
+   pool_exchange_kind,
+   htlc_kind,
+   workload_kind_count
+};
+
+const std::array< const char*, workload_kind_count > workload_kind_names = {{
+   "transfer", "limit order", "asset price publication", "property create/approve", "pool exchange", "htlc create/redeem"
+}};
+
+/**
+ * Shape of a synthetic workload. Every transaction holds a single operation, its kind is drawn according to the
+ * relative weights. Property and HTLC transactions alternate between creating an object and approving or redeeming
+ * one that was created earlier.
+ */
+struct workload_config
+{
+   uint32_t blocks = 100;
+   uint32_t transactions_per_block = 50;
+   uint32_t traders = 20;
+   std::array< uint32_t, workload_kind_count > weights = {{ 40, 30, 2, 2, 16, 10 }};
+   /// The checks skipped when the transactions are pushed and when the blocks are generated
+   uint32_t skip = database::skip_nothing;
+   uint32_t seed = 1;
+};
+
+/// Latency samples, in microseconds
+struct latency_samples
+{
+   std::vector<int64_t> samples;
+
+   void add( const fc::microseconds& elapsed ) { samples.push_back( elapsed.count() ); }
+
+   int64_t percentile( uint32_t p )
+   {
+      if( samples.empty() )
+         return 0;
+      std::sort( samples.begin(), samples.end() );
+      return samples[ std::min<size_t>( samples.size() - 1, samples.size() * p / 100 ) ];
+   }
+};
+
+struct meta1_workload_fixture : meta1_fixture
+{
+   struct trader
+   {
+      account_id_type  id;
+      private_key_type key;
+   };
+
+   struct pending_htlc
+   {
+      htlc_id_type      id;
+      size_t            redeemer;
+      std::vector<char> preimage;
+   };
+
+   private_key_type         meta1_key = generate_private_key( "meta1" );
+   account_id_type          meta1_id;
+   asset_id_type            btc_id;
+   liquidity_pool_id_type   pool_id;
+   std::vector<trader>      traders;
+   std::deque<pending_htlc> htlcs;
+   std::deque<property_id_type> properties;
+   /// The preimage of the last HTLC generated
+   std::vector<char>        last_preimage;
+   std::mt19937             rng;
+   uint64_t                 sequence = 0;
+
+   /**
+    * Create the traders, the BTC asset, a META1/BTC liquidity pool, a fully allocated property backing the META1
+    * valuation at 9 USD, and a BTC price of 2000 USD, so that META1 must trade above 1 BTC per 222 META1
+    */
+   void setup_workload( const workload_config& config )
+   {
+      rng.seed( config.seed );
+      generate_blocks( HARDFORK_LIQUIDITY_POOL_TIME );
+      set_expiration( db, trx );
+      set_htlc_committee_parameters();
+      set_expiration( db, trx );
+
+      meta1_id = create_account( "meta1", meta1_key ).id;
+      upgrade_to_lifetime_member( meta1_id );
+      const private_key_type lp_key = generate_private_key( "lp" );
+      const account_id_type lp_id = create_account( "lp", lp_key ).id;
+
+      btc_id = create_user_issued_asset( "BTC" ).id;
+      const asset_id_type share_id = create_user_issued_asset( "LPMETAONE", lp_id( db ), 0 ).id;
+      const int64_t meta1_unit = GRAPHENE_BLOCKCHAIN_PRECISION;
+      const int64_t btc_unit = asset::scaled_precision( btc_id( db ).precision ).value;
+
+      for( uint32_t i = 0; i < config.traders; ++i )
+      {
+         const string name = "trader" + fc::to_string( i );
+         const private_key_type key = generate_private_key( name );
+         traders.push_back( { create_account( name, key ).id, key } );
+         transfer( committee_account, traders.back().id, asset( 10000000 * meta1_unit ) );
+         issue_uia( traders.back().id, asset( 100000 * btc_unit, btc_id ) );
+      }
+      transfer( committee_account, lp_id, asset( 100000000 * meta1_unit ) );
+      issue_uia( lp_id, asset( 500000 * btc_unit, btc_id ) );
+
+      pool_id = create_liquidity_pool( lp_id, asset_id_type(), btc_id, share_id, 20, 0 ).id;
+      deposit_to_liquidity_pool( lp_id, pool_id, asset( 100000000 * meta1_unit ), asset( 500000 * btc_unit, btc_id ) );
+
+      allocate_property( 900000000, 60, meta1_id, meta1_key );
+      publish_asset_price( "BTC", price_ratio( 2000, 1 ), meta1_id, meta1_key );
+      generate_block();
+      trx.clear();
+   }
+
+   /// A random trader other than @p other
+   size_t random_trader( size_t other = std::numeric_limits<size_t>::max() )
+   {
+      size_t i = rng() % traders.size();
+      if( i == other )
+         i = ( i + 1 ) % traders.size();
+      return i;
+   }
+
+   /// Build the next transaction of the given kind, and return the key to sign it with
+   private_key_type make_transaction( workload_kind kind, signed_transaction& tx )
+   {
+      const int64_t meta1_unit = GRAPHENE_BLOCKCHAIN_PRECISION;
+      const int64_t btc_unit = asset::scaled_precision( btc_id( db ).precision ).value;
+      const size_t from = random_trader();
+      switch( kind )
+      {
+      case transfer_kind:
+      {
+         transfer_operation op;
+         op.from = traders[from].id;
+         op.to = traders[random_trader( from )].id;
+         op.amount = asset( 1 + rng() % ( 100 * meta1_unit ) );
+         tx.operations.push_back( op );
+         return traders[from].key;
+      }
+      case limit_order_kind:
+      {
+         // Between 10 and 12 USD per META1, above the floor of 9 USD, so that buyers and sellers cross
+         const int64_t meta1_per_btc = 167 + rng() % 34;
+         const int64_t btc = 1 + rng() % 5;
+         const asset btc_amount( btc * btc_unit, btc_id );
+         const asset meta1_amount( btc * meta1_per_btc * meta1_unit );
+         limit_order_create_operation op;
+         op.seller = traders[from].id;
+         op.amount_to_sell = ( rng() % 2 ) ? meta1_amount : btc_amount;
+         op.min_to_receive = ( op.amount_to_sell.asset_id == btc_id ) ? meta1_amount : btc_amount;
+         tx.operations.push_back( op );
+         return traders[from].key;
+      }
+      case price_publication_kind:
+      {
+         asset_price_publish_operation op;
+         op.symbol = "BTC";
+         op.usd_price = price_ratio( 1990 + rng() % 21, 1 );
+         op.fee_paying_account = meta1_id;
+         tx.operations.push_back( op );
+         return meta1_key;
+      }
+      case property_kind:
+      {
+         if( !properties.empty() && rng() % 2 )
+         {
+            property_approve_operation op;
+            op.issuer = meta1_id;
+            op.property_to_approve = properties.front();
+            properties.pop_front();
+            tx.operations.push_back( op );
+            return meta1_key;
+         }
+         const property_options options = {
+                 "workload property",
+                 "workload property",
+                 "my@email.com",
+                 "you",
+                 "https://fsf.com",
+                 "https://purepng.com/metal-1701528976849tkdsl.png",
+                 "222",
+                 1,
+                 33104,
+         };
+         tx.operations.push_back( create_property_operation( "meta1", 1000, 60, GRAPHENE_SYMBOL, options ) );
+         return meta1_key;
+      }
+      case pool_exchange_kind:
+      {
+         const asset to_sell = ( rng() % 2 ) ? asset( ( 1 + rng() % 1000 ) * meta1_unit )
+                                             : asset( ( 1 + rng() % 5 ) * btc_unit, btc_id );
+         const asset to_receive( 1, to_sell.asset_id == btc_id ? asset_id_type() : btc_id );
+         tx.operations.push_back( make_liquidity_pool_exchange_op( traders[from].id, pool_id, to_sell, to_receive ) );
+         return traders[from].key;
+      }
+      case htlc_kind:
+      default:
+      {
+         if( !htlcs.empty() && rng() % 2 )
+         {
+            const pending_htlc& pending = htlcs.front();
+            htlc_redeem_operation op;
+            op.htlc_id = pending.id;
+            op.redeemer = traders[pending.redeemer].id;
+            op.preimage = pending.preimage;
+            tx.operations.push_back( op );
+            const private_key_type key = traders[pending.redeemer].key;
+            htlcs.pop_front();
+            return key;
+         }
+         last_preimage.resize( 32 );
+         std::generate( last_preimage.begin(), last_preimage.end(), [this]() { return char( rng() ); } );
+         htlc_create_operation op;
+         op.from = traders[from].id;
+         op.to = traders[random_trader( from )].id;
+         op.amount = asset( ( 1 + rng() % 10 ) * meta1_unit );
+         op.preimage_hash = fc::sha256::hash( last_preimage.data(), last_preimage.size() );
+         op.preimage_size = last_preimage.size();
+         op.claim_period_seconds = 3600;
+         tx.operations.push_back( op );
+         return traders[from].key;
+      }
+      }
+   }
+
+   /// Remember the objects created by @p ptx which later transactions approve or redeem
+   void record_result( workload_kind kind, const processed_transaction& ptx )
+   {
+      if( kind == property_kind && ptx.operations.front().is_type<property_create_operation>() )
+      {
+         const auto& op = ptx.operations.front().get<property_create_operation>();
+         properties.push_back( db.get_property( op.property_id ).id );
+      }
+      else if( kind == htlc_kind && ptx.operations.front().is_type<htlc_create_operation>() )
+      {
+         const auto& op = ptx.operations.front().get<htlc_create_operation>();
+         const auto redeemer = std::find_if( traders.begin(), traders.end(),
+                                             [&op]( const trader& t ) { return t.id == op.to; } );
+         htlcs.push_back( { ptx.operation_results.front().get<object_id_type>(),
+                            size_t( redeemer - traders.begin() ), last_preimage } );
+      }
+   }
+
+   /**
+    * Push the workload one transaction at a time and generate a block after every
+    * @ref workload_config::transactions_per_block transactions. Log the sustained throughput, the latency of the
+    * transactions of each kind, and the latency of the generation of the blocks.
+    */
+   void run_workload( const workload_config& config )
+   {
+      const uint32_t total_weight = std::accumulate( config.weights.begin(), config.weights.end(), 0u );
+      FC_ASSERT( total_weight > 0 );
+
+      std::array< latency_samples, workload_kind_count > push_latency;
+      std::array< uint64_t, workload_kind_count > rejected = {};
+      latency_samples block_latency;
+      latency_samples interval_latency;
+      const fc::microseconds block_interval = fc::seconds( db.get_global_properties().parameters.block_interval );
+      uint32_t overrun_blocks = 0;
+      uint64_t operation_count = 0;
+
+      const auto start = fc::time_point::now();
+      for( uint32_t b = 0; b < config.blocks; ++b )
+      {
+         const auto block_start = fc::time_point::now();
+         for( uint32_t t = 0; t < config.transactions_per_block; ++t )
+         {
+            uint32_t pick = rng() % total_weight;
+            size_t kind = 0;
+            while( pick >= config.weights[kind] )
+               pick -= config.weights[kind++];
+
+            signed_transaction tx;
+            const private_key_type key = make_transaction( workload_kind( kind ), tx );
+
+            for( auto& op : tx.operations )
+               db.current_fee_schedule().set_fee( op );
+            // Distinct expirations keep otherwise identical transactions apart
+            tx.set_reference_block( db.head_block_id() );
+            tx.set_expiration( db.head_block_time() + fc::seconds( 60 + ( sequence++ % 3600 ) ) );
+            sign( tx, key );
+
+            const auto push_start = fc::time_point::now();
+            try
+            {
+               const processed_transaction ptx = PUSH_TX( db, tx, config.skip );
+               push_latency[kind].add( fc::time_point::now() - push_start );
+               ++operation_count;
+               record_result( workload_kind( kind ), ptx );
+            }
+            catch( const fc::exception& e )
+            {
+               // Only the first rejection of each kind is logged
+               if( ++rejected[kind] == 1 )
+                  edump( (workload_kind_names[kind])(e.to_detail_string()) );
+            }
+         }
+
+         const auto generate_start = fc::time_point::now();
+         generate_block( config.skip );
+         const auto block_end = fc::time_point::now();
+         block_latency.add( block_end - generate_start );
+         interval_latency.add( block_end - block_start );
+         if( block_end - block_start > block_interval )
+            ++overrun_blocks;
+      }
+      const auto elapsed = fc::time_point::now() - start;
+
+      wlog( "Workload of ${b} blocks: ${n} operations in ${t} ms, ${r} operations/s, ${o} blocks took longer than "
+            "the block interval",
+            ("b", config.blocks)("n", operation_count)("t", elapsed.count() / 1000)
+            ("r", operation_count * 1000000 / std::max<int64_t>( elapsed.count(), 1 ))("o", overrun_blocks) );
+      for( size_t kind = 0; kind < workload_kind_count; ++kind )
+      {
+         if( push_latency[kind].samples.empty() && rejected[kind] == 0 )
+            continue;
+         wlog( "${k}: ${n} pushed, ${x} rejected, latency p50 ${p50} us, p99 ${p99} us, max ${max} us",
+               ("k", workload_kind_names[kind])("n", push_latency[kind].samples.size())("x", rejected[kind])
+               ("p50", push_latency[kind].percentile( 50 ))("p99", push_latency[kind].percentile( 99 ))
+               ("max", push_latency[kind].percentile( 100 )) );
+         BOOST_CHECK( !push_latency[kind].samples.empty() );
+      }
+      wlog( "Block generation: p50 ${p50} us, p99 ${p99} us, max ${max} us",
+            ("p50", block_latency.percentile( 50 ))("p99", block_latency.percentile( 99 ))
+            ("max", block_latency.percentile( 100 )) );
+      wlog( "Block interval, pushes and generation: p50 ${p50} us, p99 ${p99} us, max ${max} us",
+            ("p50", interval_latency.percentile( 50 ))("p99", interval_latency.percentile( 99 ))
+            ("max", interval_latency.percentile( 100 )) );
+   }
+};
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE( meta1_workload_tests, meta1_workload_fixture )
+
+/**
+ * A mix of all the kinds of transactions, in proportions resembling the use of the chain
+ */
+BOOST_AUTO_TEST_CASE( mixed_workload )
+{ try {
+   workload_config config;
+#ifdef NDEBUG
+   config.blocks = 500;
+   config.transactions_per_block = 200;
+#endif
+   setup_workload( config );
+   run_workload( config );
+} FC_LOG_AND_RETHROW() }
+
+/**
+ * Trading only, where the price floor of the limit orders, the matching and the pool exchanges dominate
+ */
+BOOST_AUTO_TEST_CASE( market_workload )
+{ try {
+   workload_config config;
+   config.weights = {{ 0, 70, 1, 0, 29, 0 }};
+#ifdef NDEBUG
+   config.blocks = 500;
+   config.transactions_per_block = 200;
+#endif
+   setup_workload( config );
+   run_workload( config );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
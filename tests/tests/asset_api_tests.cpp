@@ -60,6 +60,49 @@ BOOST_AUTO_TEST_CASE( asset_holders )
    BOOST_CHECK(holders[2].name == "alice");
    BOOST_CHECK(holders[3].name == "dan");
 }
+BOOST_AUTO_TEST_CASE( asset_holders_pagination )
+{
+   graphene::app::asset_api asset_api(app);
+   const std::string core = std::string( static_cast<object_id_type>(asset_id_type()) );
+
+   auto dan = create_account("dan");
+   auto bob = create_account("bob");
+   auto alice = create_account("alice");
+   auto carl = create_account("carl");
+
+   transfer(account_id_type()(db), dan, asset(100));
+   transfer(account_id_type()(db), alice, asset(200));
+   transfer(account_id_type()(db), bob, asset(200));
+   transfer(account_id_type()(db), carl, asset(300));
+   BOOST_CHECK_EQUAL( asset_api.get_asset_holders_count( core ), 5 );
+
+   // walk through the holders two by two, the pages follow each other
+   const vector<account_asset_balance> all_holders = asset_api.get_asset_holders( core, 0, 100 );
+   BOOST_REQUIRE_EQUAL( all_holders.size(), 5u );
+   vector<account_asset_balance> paged = asset_api.get_asset_holders_after( core, {}, {}, 2 );
+   while( true )
+   {
+      const account_asset_balance& last = paged.back();
+      const auto page = asset_api.get_asset_holders_after( core, last.amount, last.account_id, 2 );
+      if( page.empty() )
+         break;
+      paged.insert( paged.end(), page.begin(), page.end() );
+   }
+   BOOST_REQUIRE_EQUAL( paged.size(), all_holders.size() );
+   for( size_t i = 0; i < paged.size(); ++i )
+      BOOST_CHECK( paged[i].account_id == all_holders[i].account_id );
+
+   // start with the largest holder of at most the given amount
+   const auto page = asset_api.get_asset_holders_after( core, share_type(200), {}, 100 );
+   BOOST_REQUIRE_EQUAL( page.size(), 3u );
+   BOOST_CHECK( page[0].account_id == std::min( alice.id, bob.id ) );
+   BOOST_CHECK( page[2].account_id == dan.id );
+
+   // holders without a balance are not counted
+   transfer(dan, account_id_type()(db), asset(100));
+   BOOST_CHECK_EQUAL( asset_api.get_asset_holders_count( core ), 4 );
+   BOOST_CHECK_EQUAL( asset_api.get_asset_holders_after( core, {}, {}, 100 ).size(), 4u );
+}
 BOOST_AUTO_TEST_CASE( api_limit_get_asset_holders )
 {
    graphene::app::asset_api asset_api(app);
@@ -511,6 +511,131 @@ BOOST_FIXTURE_TEST_SUITE(asset_price_tests, meta1_fixture)
    }
 
 
+   /**
+    * Publish the prices of several external assets in a single operation
+    */
+   BOOST_AUTO_TEST_CASE(publish_asset_price_batch_test) {
+      try {
+         /**
+          * Initialize
+          */
+         set_expiration(db, trx);
+
+         // Initialize the actors
+         ACTORS((nathan)(meta1));
+         upgrade_to_lifetime_member(meta1_id);
+
+         create_user_issued_asset("BTC");
+         create_user_issued_asset("ETH");
+
+         asset_price_publish_batch_operation publish_op;
+         publish_op.usd_prices["BTC"] = price_ratio(2000, 1); // 2000 USD per BTC
+         publish_op.usd_prices["ETH"] = price_ratio(301, 2); // 150.5 USD per ETH
+         publish_op.fee_paying_account = meta1_id;
+
+         // Publishing a batch before the hardfork should fail, directly or through a proposal
+         trx.clear();
+         trx.operations.push_back(publish_op);
+         sign(trx, meta1_private_key);
+
+         REQUIRE_EXCEPTION_WITH_TEXT(PUSH_TX(db, trx), "Not allowed until");
+         BOOST_CHECK_THROW(propose(publish_op), fc::exception);
+
+
+         // Advance past the hardfork
+         generate_blocks(HARDFORK_ASSET_PRICE_BATCH_TIME);
+         set_expiration(db, trx);
+         time_point_sec now = db.head_block_time();
+
+         // Ensure that only approved accounts can publish the batch
+         publish_op.fee_paying_account = nathan_id;
+
+         trx.clear();
+         trx.operations.push_back(publish_op);
+         sign(trx, nathan_private_key);
+
+         REQUIRE_EXCEPTION_WITH_TEXT(PUSH_TX(db, trx), "only by approved accounts");
+
+
+         // Ensure that every asset in the batch exists on the blockchain
+         publish_op.fee_paying_account = meta1_id;
+         publish_op.usd_prices["USDT"] = price_ratio(1, 1);
+
+         trx.clear();
+         trx.operations.push_back(publish_op);
+         sign(trx, meta1_private_key);
+
+         REQUIRE_EXCEPTION_WITH_TEXT(PUSH_TX(db, trx), "should exist on the blockchain");
+
+         // Nothing from the rejected batch should have been published
+         const auto &idx = db.get_index_type<asset_price_index>().indices().get<by_symbol>();
+         BOOST_CHECK(idx.find("BTC") == idx.end());
+         BOOST_CHECK(idx.find("ETH") == idx.end());
+
+
+         // Publish the batch of existing assets
+         publish_op.usd_prices.erase("USDT");
+
+         trx.clear();
+         trx.operations.push_back(publish_op);
+         sign(trx, meta1_private_key);
+
+         PUSH_TX(db, trx);
+
+         auto itr = idx.find("BTC");
+         BOOST_REQUIRE(itr != idx.end());
+         BOOST_CHECK_EQUAL(itr->usd_price.numerator, 2000);
+         BOOST_CHECK_EQUAL(itr->usd_price.denominator, 1);
+         BOOST_CHECK(itr->publication_time == now);
+
+         itr = idx.find("ETH");
+         BOOST_REQUIRE(itr != idx.end());
+         BOOST_CHECK_EQUAL(itr->usd_price.numerator, 301);
+         BOOST_CHECK_EQUAL(itr->usd_price.denominator, 2);
+         BOOST_CHECK(itr->publication_time == now);
+
+
+         // Update a subset of the previously published prices
+         generate_blocks(10);
+         set_expiration(db, trx);
+         const time_point_sec before = now;
+         now = db.head_block_time();
+
+         publish_op.usd_prices.clear();
+         publish_op.usd_prices["ETH"] = price_ratio(160, 1); // 160 USD per ETH
+
+         trx.clear();
+         trx.operations.push_back(publish_op);
+         sign(trx, meta1_private_key);
+
+         PUSH_TX(db, trx);
+
+         itr = idx.find("ETH");
+         BOOST_REQUIRE(itr != idx.end());
+         BOOST_CHECK_EQUAL(itr->usd_price.numerator, 160);
+         BOOST_CHECK_EQUAL(itr->usd_price.denominator, 1);
+         BOOST_CHECK(itr->publication_time == now);
+
+         // The price that was not in the batch should be unchanged
+         itr = idx.find("BTC");
+         BOOST_REQUIRE(itr != idx.end());
+         BOOST_CHECK_EQUAL(itr->usd_price.numerator, 2000);
+         BOOST_CHECK(itr->publication_time == before);
+
+
+         // An empty batch is invalid
+         publish_op.usd_prices.clear();
+         trx.clear();
+         trx.operations.push_back(publish_op);
+         sign(trx, meta1_private_key);
+
+         GRAPHENE_REQUIRE_THROW(PUSH_TX(db, trx), fc::exception);
+
+      }
+      FC_LOG_AND_RETHROW()
+   }
+
+
    /**
     * Test the minimum prices for new limit orders
     */
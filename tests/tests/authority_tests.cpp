@@ -2249,4 +2249,207 @@ BOOST_AUTO_TEST_CASE( self_deleting_proposal )
    db.get<proposal_object>(pid1);
 } FC_LOG_AND_RETHROW() }
 
+/// A transaction received again as a different object is not recovered again
+BOOST_AUTO_TEST_CASE( signature_key_cache_test )
+{ try {
+   fc::ecc::private_key nathan_key = fc::ecc::private_key::generate();
+   fc::ecc::private_key dan_key = fc::ecc::private_key::generate();
+
+   transfer_operation op;
+   op.from = account_id_type(1);
+   op.to = account_id_type(2);
+   op.amount = asset(500);
+   signed_transaction tx;
+   tx.operations.push_back(op);
+   set_expiration( db, tx );
+   tx.sign( nathan_key, db.get_chain_id() );
+   tx.sign( dan_key, db.get_chain_id() );
+
+   signature_key_cache& cache = signature_key_cache::instance();
+   const signature_key_cache_stats before = cache.get_stats();
+
+   const flat_set<public_key_type> keys = tx.get_signature_keys( db.get_chain_id() );
+   const signature_key_cache_stats after_first = cache.get_stats();
+   BOOST_CHECK_EQUAL( after_first.misses, before.misses + 2 );
+   BOOST_CHECK_EQUAL( after_first.hits, before.hits );
+
+   const signed_transaction copy( tx );
+   BOOST_CHECK( copy.get_signature_keys( db.get_chain_id() ) == keys );
+   const signature_key_cache_stats after_copy = cache.get_stats();
+   BOOST_CHECK_EQUAL( after_copy.misses, after_first.misses );
+   BOOST_CHECK_EQUAL( after_copy.hits, after_first.hits + 2 );
+
+   BOOST_CHECK( keys.find( nathan_key.get_public_key() ) != keys.end() );
+   BOOST_CHECK( keys.find( dan_key.get_public_key() ) != keys.end() );
+
+   // duplicate signatures are still detected when the keys come from the cache
+   signed_transaction duplicate( tx );
+   duplicate.signatures.push_back( duplicate.signatures.front() );
+   GRAPHENE_REQUIRE_THROW( duplicate.get_signature_keys( db.get_chain_id() ), tx_duplicate_sig );
+
+   // a disabled cache recovers every time
+   cache.set_capacity( 0 );
+   const signature_key_cache_stats before_disabled = cache.get_stats();
+   BOOST_CHECK( copy.get_signature_keys( db.get_chain_id() ) == keys );
+   BOOST_CHECK_EQUAL( cache.get_stats().hits, before_disabled.hits );
+   BOOST_CHECK_EQUAL( cache.get_stats().misses, before_disabled.misses + 2 );
+   BOOST_CHECK_EQUAL( cache.get_stats().size, 0u );
+   cache.set_capacity( signature_key_cache::default_capacity );
+
+} FC_LOG_AND_RETHROW() }
+
+/// Signatures verified once are not accepted any more after the authority they satisfied changes, also when the
+/// change is undone
+BOOST_AUTO_TEST_CASE( verified_authority_cache_test )
+{ try {
+   ACTORS( (alice)(bob) );
+   transfer( account_id_type(), alice_id, asset(100000) );
+   const fc::ecc::private_key new_key = generate_private_key( "alice_new" );
+
+   const auto transfer_to_bob = [&]( int64_t amount, const fc::ecc::private_key& key ) {
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset( amount );
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+      sign( tx, key );
+      return tx;
+   };
+
+   // the same signer is verified for several transactions
+   PUSH_TX( db, transfer_to_bob( 100, alice_private_key ) );
+   PUSH_TX( db, transfer_to_bob( 200, alice_private_key ) );
+
+   account_update_operation uop;
+   uop.account = alice_id;
+   uop.active = authority( 1, public_key_type( new_key.get_public_key() ), 1 );
+   trx.operations.push_back( uop );
+   sign( trx, alice_private_key );
+
+   {
+      // the change of the active authority is undone with the session
+      auto session = db._undo_db.start_undo_session();
+      PUSH_TX( db, trx );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX( db, transfer_to_bob( 300, alice_private_key ) ), fc::exception );
+      PUSH_TX( db, transfer_to_bob( 400, new_key ) );
+      session.undo();
+   }
+   PUSH_TX( db, transfer_to_bob( 500, alice_private_key ) );
+   GRAPHENE_REQUIRE_THROW( PUSH_TX( db, transfer_to_bob( 600, new_key ) ), fc::exception );
+
+   PUSH_TX( db, trx );
+   trx.clear();
+   GRAPHENE_REQUIRE_THROW( PUSH_TX( db, transfer_to_bob( 700, alice_private_key ) ), fc::exception );
+   PUSH_TX( db, transfer_to_bob( 800, new_key ) );
+
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 100 + 200 + 500 + 800 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( expired_proposal_sweep_test )
+{ try {
+   generate_blocks( HARDFORK_EXPIRATION_SWEEP_TIME );
+   set_expiration( db, trx );
+   ACTORS( (alice)(bob) );
+   transfer( account_id_type(), alice_id, asset(100000) );
+   transfer( account_id_type(), bob_id, asset(100000) );
+   const fc::ecc::private_key new_key = generate_private_key( "alice_new" );
+   const required_approval_index& approvals = db.get_required_approval_index();
+
+   // more proposals than a block handles, all expiring at the same time
+   const uint32_t proposal_count = GRAPHENE_MAX_EXPIRED_PROPOSALS_PER_BLOCK + 10;
+   const fc::time_point_sec expiration = db.head_block_time() + fc::hours(1);
+   {
+      transfer_operation top;
+      top.from = alice_id;
+      top.to = bob_id;
+      top.amount = asset(100);
+
+      proposal_create_operation pop;
+      pop.proposed_ops.emplace_back( top );
+      pop.fee_paying_account = bob_id;
+      pop.expiration_time = expiration;
+      for( uint32_t i = 0; i < proposal_count; ++i )
+         trx.operations.push_back( pop );
+      sign( trx, bob_private_key );
+      PUSH_TX( db, trx );
+      trx.clear();
+   }
+   const auto& proposal_idx = db.get_index_type<proposal_index>().indices();
+   BOOST_REQUIRE_EQUAL( proposal_idx.size(), proposal_count );
+   const proposal_id_type pid = proposal_idx.begin()->id;
+
+   proposal_update_operation uop;
+   uop.proposal = pid;
+   uop.fee_paying_account = bob_id;
+   uop.active_approvals_to_add.insert( bob_id );
+   trx.operations.push_back( uop );
+   sign( trx, bob_private_key );
+   PUSH_TX( db, trx );
+   trx.clear();
+   // producing the block applies the update again, each time changing the approvals and checking the proposal
+   generate_block();
+   uint64_t checks = approvals.get_checks();
+   uint64_t skipped_checks = approvals.get_skipped_checks();
+
+   // approving it again changes nothing, the failed check is not repeated
+   set_expiration( db, trx );
+   trx.operations.push_back( uop );
+   sign( trx, bob_private_key );
+   PUSH_TX( db, trx );
+   trx.clear();
+   BOOST_CHECK_EQUAL( approvals.get_checks(), checks );
+   BOOST_CHECK_EQUAL( approvals.get_skipped_checks(), skipped_checks + 1 );
+   generate_block();
+
+   // an account was created, which may satisfy an authority naming it, the proposal is checked again
+   checks = approvals.get_checks();
+   set_expiration( db, trx );
+   create_account( "carol" );
+   trx.operations.push_back( uop );
+   sign( trx, bob_private_key );
+   PUSH_TX( db, trx );
+   trx.clear();
+   BOOST_CHECK_EQUAL( approvals.get_checks(), checks + 1 );
+   generate_block();
+
+   // the authorities of the accounts changed, the proposal is checked again
+   checks = approvals.get_checks();
+   account_update_operation aop;
+   aop.account = alice_id;
+   aop.active = authority( 1, public_key_type( new_key.get_public_key() ), 1 );
+   set_expiration( db, trx );
+   trx.operations.push_back( aop );
+   sign( trx, alice_private_key );
+   PUSH_TX( db, trx );
+   trx.clear();
+   trx.operations.push_back( uop );
+   sign( trx, bob_private_key );
+   PUSH_TX( db, trx );
+   trx.clear();
+   BOOST_CHECK_EQUAL( approvals.get_checks(), checks + 1 );
+   BOOST_CHECK( db.find( pid ) != nullptr );
+   generate_block();
+
+   // the first block after the expiration removes a bounded batch, the next block the rest
+   generate_blocks( expiration );
+   BOOST_CHECK_EQUAL( proposal_idx.size(), proposal_count - GRAPHENE_MAX_EXPIRED_PROPOSALS_PER_BLOCK );
+   BOOST_CHECK( db.find( pid ) == nullptr );
+
+   // the expired proposals left can no longer be approved
+   uop.proposal = proposal_idx.rbegin()->id;
+   set_expiration( db, trx );
+   trx.operations.push_back( uop );
+   sign( trx, bob_private_key );
+   GRAPHENE_REQUIRE_THROW( PUSH_TX( db, trx ), fc::exception );
+   trx.clear();
+
+   generate_block();
+   BOOST_CHECK( proposal_idx.empty() );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), 100000 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -719,13 +719,31 @@ BOOST_AUTO_TEST_CASE( duplicate_transactions )
 
       GRAPHENE_CHECK_THROW(PUSH_TX( db1, trx, skip_sigs ), fc::exception);
 
+      // a pending transaction is found among the pending transactions
+      BOOST_REQUIRE( db1.get_recent_transaction( trx.id() ).valid() );
+      BOOST_CHECK( db1.get_recent_transaction( trx.id() )->id() == trx.id() );
+      BOOST_CHECK( !db2.get_recent_transaction( trx.id() ).valid() );
+
       auto b = db1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness( 1 ), init_account_priv_key, skip_sigs );
       PUSH_BLOCK( db2, b, skip_sigs );
 
       GRAPHENE_CHECK_THROW(PUSH_TX( db1, trx, skip_sigs ), fc::exception);
       GRAPHENE_CHECK_THROW(PUSH_TX( db2, trx, skip_sigs ), fc::exception);
+
+      // an included transaction is found in its block
+      BOOST_REQUIRE( db1.get_recent_transaction( trx.id() ).valid() );
+      BOOST_CHECK( db1.get_recent_transaction( trx.id() )->id() == trx.id() );
+      BOOST_REQUIRE( db2.get_recent_transaction( trx.id() ).valid() );
+      BOOST_CHECK( db2.get_recent_transaction( trx.id() )->id() == trx.id() );
       BOOST_CHECK_EQUAL(db1.get_balance(nathan_id, asset_id_type()).amount.value, 500);
       BOOST_CHECK_EQUAL(db2.get_balance(nathan_id, asset_id_type()).amount.value, 500);
+
+      // a transaction of a popped block pushed again is pending, not in the block which is gone
+      db2.pop_block();
+      BOOST_CHECK( !db2.get_recent_transaction( trx.id() ).valid() );
+      PUSH_TX( db2, trx, skip_sigs );
+      BOOST_REQUIRE( db2.get_recent_transaction( trx.id() ).valid() );
+      BOOST_CHECK( db2.get_recent_transaction( trx.id() )->id() == trx.id() );
    } catch (fc::exception& e) {
       edump((e.to_detail_string()));
       throw;
@@ -1935,4 +1953,141 @@ BOOST_FIXTURE_TEST_CASE( block_size_test, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( block_phase_stats_test, database_fixture )
+{
+   try
+   {
+      const auto phase_count = [this]( block_phase phase ) {
+         return db.get_block_phase_stats()[ size_t( phase ) ].count;
+      };
+
+      const uint64_t pushed = phase_count( block_phase::block_push );
+      const uint64_t applied = phase_count( block_phase::transactions );
+      const uint64_t maintained = phase_count( block_phase::maintenance );
+
+      generate_block();
+
+      BOOST_CHECK_EQUAL( phase_count( block_phase::pending_transactions_popped ), pushed + 1 );
+      BOOST_CHECK_EQUAL( phase_count( block_phase::block_push ), pushed + 1 );
+      BOOST_CHECK_EQUAL( phase_count( block_phase::pending_transactions_restored ), pushed + 1 );
+      BOOST_CHECK_EQUAL( phase_count( block_phase::transactions ), applied + 1 );
+      BOOST_CHECK_EQUAL( phase_count( block_phase::changed_objects_signal ), applied + 1 );
+      BOOST_CHECK_EQUAL( phase_count( block_phase::maintenance ), maintained );
+
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+      BOOST_CHECK_EQUAL( phase_count( block_phase::maintenance ), maintained + 1 );
+
+      // every measure is counted in exactly one bucket of the histogram
+      for( const block_phase_stats& stats : db.get_block_phase_stats() )
+      {
+         uint64_t counted = 0;
+         for( uint64_t bucket : stats.histogram )
+            counted += bucket;
+         BOOST_CHECK_EQUAL( counted, stats.count );
+         BOOST_CHECK( stats.max <= stats.total );
+      }
+
+      // tracing slow blocks does not get in the way
+      const uint64_t pushed_before_trace = phase_count( block_phase::block_push );
+      db.set_slow_block_threshold( fc::microseconds( 1 ) );
+      generate_block();
+      BOOST_CHECK_EQUAL( phase_count( block_phase::block_push ), pushed_before_trace + 1 );
+   }
+   catch( fc::exception& e )
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_FIXTURE_TEST_CASE( memoized_packed_sizes_test, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+
+      for( int i = 1; i <= 3; ++i )
+      {
+         transfer_operation op;
+         op.from = alice_id;
+         op.to = bob_id;
+         op.amount = asset( i );
+         signed_transaction tx;
+         tx.operations.push_back( op );
+         set_expiration( db, tx );
+         sign( tx, alice_private_key );
+         PUSH_TX( db, tx );
+      }
+
+      // the sizes computed to generate the block are reused to apply it
+      const packed_size_stats before = get_packed_size_stats();
+      const signed_block block = generate_block( database::skip_nothing );
+      const packed_size_stats after = get_packed_size_stats();
+      BOOST_REQUIRE_EQUAL( block.transactions.size(), 3u );
+      BOOST_CHECK_GE( after.reused - before.reused, 6u );
+
+      BOOST_CHECK_EQUAL( block.get_packed_size(), fc::raw::pack_size( block ) );
+      for( const processed_transaction& trx : block.transactions )
+         BOOST_CHECK_EQUAL( trx.get_serialized_size(), fc::raw::pack_size( trx ) );
+
+      // a block received from the network computes the same sizes
+      const signed_block received = fc::raw::unpack<signed_block>( fc::raw::pack( block ) );
+      BOOST_CHECK_EQUAL( received.get_packed_size(), fc::raw::pack_size( block ) );
+      BOOST_CHECK_EQUAL( received.get_packed_size(), block.get_packed_size() );
+
+      // an empty block
+      const signed_block empty = generate_block();
+      BOOST_CHECK_EQUAL( empty.get_packed_size(), fc::raw::pack_size( empty ) );
+   }
+   catch( fc::exception& e )
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_FIXTURE_TEST_CASE( operation_timing_stats_test, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      BOOST_CHECK( db.get_operation_timing_stats().empty() );
+
+      db.set_operation_timing_enabled( true );
+      const int transfer_tag = operation::tag<transfer_operation>::value;
+      BOOST_CHECK_EQUAL( operation_type_name( transfer_tag ), "transfer_operation" );
+
+      transfer( alice_id, bob_id, asset( 1 ) );
+      transfer( alice_id, bob_id, asset( 2 ) );
+      const operation_timing_stats& transfers = db.get_operation_timing_stats()[ transfer_tag ];
+      BOOST_CHECK_EQUAL( transfers.evaluate.count, 2u );
+      BOOST_CHECK_EQUAL( transfers.apply.count, 2u );
+
+      // a failed operation is not counted as applied
+      transfer_operation op;
+      op.from = bob_id;
+      op.to = alice_id;
+      op.amount = asset( 1000 );
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      set_expiration( db, tx );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX( db, tx, ~0 ), fc::exception );
+      BOOST_CHECK_EQUAL( db.get_operation_timing_stats()[ transfer_tag ].apply.count, 2u );
+
+      // the measures are logged at maintenance
+      generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+
+      db.set_operation_timing_enabled( false );
+      BOOST_CHECK( db.get_operation_timing_stats().empty() );
+   }
+   catch( fc::exception& e )
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -310,4 +310,114 @@ BOOST_AUTO_TEST_CASE( required_approval_index_test ) // see https://github.com/b
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( balances_by_asset_index_test )
+{ try {
+   ACTORS( (alice)(bob)(carl) );
+   const asset_id_type usd_id = create_user_issued_asset( "MYUSD" ).id;
+   set_expiration( db, trx );
+   issue_uia( alice_id, asset( 300, usd_id ) );
+   issue_uia( bob_id, asset( 200, usd_id ) );
+   issue_uia( carl_id, asset( 200, usd_id ) );
+
+   const auto& by_asset = db.get_index_type< primary_index< account_balance_index > >()
+                             .get_secondary_index< balances_by_asset_index >();
+   const auto& by_account = db.get_index_type< primary_index< account_balance_index > >()
+                               .get_secondary_index< balances_by_account_index >();
+   const auto& balances = by_asset.get_asset_balances( db, usd_id );
+
+   auto check_order = [&]( const vector< pair<account_id_type, int64_t> >& expected ) {
+      BOOST_REQUIRE_EQUAL( balances.size(), expected.size() );
+      auto itr = balances.begin();
+      for( const auto& e : expected )
+      {
+         BOOST_CHECK( itr->first.second == e.first );
+         BOOST_CHECK_EQUAL( itr->first.first.value, e.second );
+         BOOST_CHECK_EQUAL( itr->second->balance.value, e.second );
+         ++itr;
+      }
+   };
+   check_order( { { alice_id, 300 }, { bob_id, 200 }, { carl_id, 200 } } );
+
+   {
+      // the sorted balances follow the transfers, and their undo
+      auto session = db._undo_db.start_undo_session();
+      transfer( alice_id, carl_id, asset( 300, usd_id ) );
+      check_order( { { carl_id, 500 }, { bob_id, 200 } } );
+      // the empty balance is still kept for the account
+      BOOST_CHECK_EQUAL( by_account.get_account_balances( alice_id ).size(), 1u );
+      session.undo();
+   }
+   check_order( { { alice_id, 300 }, { bob_id, 200 }, { carl_id, 200 } } );
+
+   transfer( carl_id, bob_id, asset( 50, usd_id ) );
+   check_order( { { alice_id, 300 }, { bob_id, 250 }, { carl_id, 150 } } );
+   BOOST_CHECK_EQUAL( db.get_balance( carl_id, usd_id ).amount.value, 150 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( balances_by_asset_index_eviction_test )
+{ try {
+   ACTORS( (alice)(bob) );
+   transfer( committee_account, alice_id, asset( 1000 ) );
+
+   const auto& by_asset = db.get_index_type< primary_index< account_balance_index > >()
+                             .get_secondary_index< balances_by_asset_index >();
+   const size_t max_sorted = balances_by_asset_index::max_sorted_assets;
+
+   // the core balances are requested first, then as many other assets as are kept
+   by_asset.get_asset_balances( db, asset_id_type() );
+   for( size_t i = 1; i < max_sorted; ++i )
+      by_asset.get_asset_balances( db, asset_id_type( i ) );
+   BOOST_CHECK_EQUAL( by_asset.get_sorted_asset_count(), max_sorted );
+
+   // requesting the core balances again makes them the most recent, so the next asset drops asset 1
+   by_asset.get_asset_balances( db, asset_id_type() );
+   by_asset.get_asset_balances( db, asset_id_type( max_sorted ) );
+   BOOST_CHECK_EQUAL( by_asset.get_sorted_asset_count(), max_sorted );
+   BOOST_CHECK( by_asset.has_sorted_balances( asset_id_type() ) );
+   BOOST_CHECK( !by_asset.has_sorted_balances( asset_id_type( 1 ) ) );
+   BOOST_CHECK( by_asset.has_sorted_balances( asset_id_type( max_sorted ) ) );
+
+   // the balances kept sorted still follow the transfers
+   transfer( alice_id, bob_id, asset( 400 ) );
+   const auto& core_balances = by_asset.get_asset_balances( db, asset_id_type() );
+   BOOST_CHECK( core_balances.find( std::make_pair( share_type( 600 ), alice_id ) ) != core_balances.end() );
+   BOOST_CHECK( core_balances.find( std::make_pair( share_type( 400 ), bob_id ) ) != core_balances.end() );
+   BOOST_CHECK( core_balances.find( std::make_pair( share_type( 1000 ), alice_id ) ) == core_balances.end() );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( impacted_accounts_on_request_test )
+{ try {
+   ACTORS( (alice)(bob) );
+   transfer( committee_account, alice_id, asset( 1000 ) );
+   generate_block();
+
+   bool computed_before_request = true;
+   bool computed_for_next_observer = false;
+   flat_set<account_id_type> impacted;
+   boost::signals2::scoped_connection ignoring = db.changed_objects.connect(
+         [&]( const vector<object_id_type>&, const impacted_accounts_cache& accounts ) {
+      computed_before_request = accounts.is_computed();
+   });
+   boost::signals2::scoped_connection requesting = db.changed_objects.connect(
+         [&]( const vector<object_id_type>&, const impacted_accounts_cache& accounts ) {
+      impacted = accounts.get();
+   });
+   boost::signals2::scoped_connection reusing = db.changed_objects.connect(
+         [&]( const vector<object_id_type>&, const impacted_accounts_cache& accounts ) {
+      computed_for_next_observer = accounts.is_computed();
+   });
+
+   transfer( alice_id, bob_id, asset( 100 ) );
+   generate_block();
+
+   // the accounts are computed by the first observer asking for them, and reused by the next ones
+   BOOST_CHECK( !computed_before_request );
+   BOOST_CHECK( computed_for_next_observer );
+   BOOST_CHECK( impacted.find( alice_id ) != impacted.end() );
+   BOOST_CHECK( impacted.find( bob_id ) != impacted.end() );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
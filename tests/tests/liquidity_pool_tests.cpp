@@ -997,4 +997,103 @@ BOOST_AUTO_TEST_CASE( liquidity_pool_exchange_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( liquidity_pool_route_exchange_test )
+{ try {
+
+      generate_blocks( HARDFORK_LIQUIDITY_POOL_TIME );
+      set_expiration( db, trx );
+
+      ACTORS((sam)(ted));
+
+      const asset_id_type aaa_id = create_user_issued_asset( "AAA", sam, charge_market_fee ).id;
+      const asset_id_type bbb_id = create_user_issued_asset( "BBB", sam, charge_market_fee ).id;
+      const asset_id_type ccc_id = create_user_issued_asset( "CCC", sam, charge_market_fee ).id;
+      const asset_id_type lpab_id = create_user_issued_asset( "LPAB", sam, charge_market_fee ).id;
+      const asset_id_type lpbc_id = create_user_issued_asset( "LPBC", sam, charge_market_fee ).id;
+      const asset_id_type lpac_id = create_user_issued_asset( "LPAC", sam, charge_market_fee ).id;
+
+      issue_uia( sam_id, asset( 10000, aaa_id ) );
+      issue_uia( sam_id, asset( 10000, bbb_id ) );
+      issue_uia( sam_id, asset( 10000, ccc_id ) );
+      issue_uia( ted_id, asset( 200, aaa_id ) );
+
+      // Two deep pools from AAA to CCC through BBB, and a shallow direct one
+      const liquidity_pool_id_type ab_id = create_liquidity_pool( sam_id, aaa_id, bbb_id, lpab_id, 0, 0 ).id;
+      const liquidity_pool_id_type bc_id = create_liquidity_pool( sam_id, bbb_id, ccc_id, lpbc_id, 0, 0 ).id;
+      const liquidity_pool_id_type ac_id = create_liquidity_pool( sam_id, aaa_id, ccc_id, lpac_id, 0, 0 ).id;
+      deposit_to_liquidity_pool( sam_id, ab_id, asset( 1000, aaa_id ), asset( 1000, bbb_id ) );
+      deposit_to_liquidity_pool( sam_id, bc_id, asset( 1000, bbb_id ), asset( 1000, ccc_id ) );
+      deposit_to_liquidity_pool( sam_id, ac_id, asset( 100, aaa_id ), asset( 100, ccc_id ) );
+
+      auto make_route_op = [&]( const vector<liquidity_pool_id_type>& pools, int64_t min_to_receive ) {
+         liquidity_pool_route_exchange_operation op;
+         op.account = ted_id;
+         op.pools = pools;
+         op.amount_to_sell = asset( 100, aaa_id );
+         op.min_to_receive = asset( min_to_receive, ccc_id );
+         trx.operations.clear();
+         trx.operations.push_back( op );
+         for( auto& o : trx.operations ) db.current_fee_schedule().set_fee(o);
+         set_expiration( db, trx );
+      };
+
+      // Not allowed before the hard fork
+      make_route_op( { ab_id, bc_id }, 1 );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX(db, trx, ~0), fc::exception );
+
+      generate_blocks( HARDFORK_LIQUIDITY_POOL_ROUTE_TIME );
+      generate_block();
+
+      graphene::app::application_options opt = app.get_options();
+      graphene::app::database_api db_api( db, &opt );
+
+      // 100 AAA buy 90 BBB in the first pool, which buy 82 CCC in the second one, the direct pool only pays 50
+      auto route = db_api.get_liquidity_pool_route( "AAA", 100, "CCC" );
+      BOOST_REQUIRE( route.valid() );
+      BOOST_REQUIRE_EQUAL( route->pools.size(), 2u );
+      BOOST_CHECK( route->pools[0] == ab_id );
+      BOOST_CHECK( route->pools[1] == bc_id );
+      BOOST_CHECK_EQUAL( route->amount_to_receive.amount.value, 82 );
+      BOOST_CHECK( route->amount_to_receive.asset_id == ccc_id );
+
+      route = db_api.get_liquidity_pool_route( "AAA", 100, "CCC", 1 );
+      BOOST_REQUIRE( route.valid() );
+      BOOST_REQUIRE_EQUAL( route->pools.size(), 1u );
+      BOOST_CHECK( route->pools[0] == ac_id );
+      BOOST_CHECK_EQUAL( route->amount_to_receive.amount.value, 50 );
+
+      BOOST_CHECK( !db_api.get_liquidity_pool_route( "AAA", 100, "LPAB" ).valid() );
+
+      // The pools must connect the assets, in order, each pool once, and pay enough
+      make_route_op( { bc_id, ab_id }, 1 );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX(db, trx, ~0), fc::exception );
+      make_route_op( { ab_id, ab_id }, 1 );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX(db, trx, ~0), fc::exception );
+      make_route_op( { ab_id, bc_id }, 83 );
+      GRAPHENE_REQUIRE_THROW( PUSH_TX(db, trx, ~0), fc::exception );
+
+      make_route_op( { ab_id, bc_id }, 82 );
+      processed_transaction ptx = PUSH_TX(db, trx, ~0);
+      const auto& result = ptx.operation_results.front().get<generic_exchange_operation_result>();
+      BOOST_REQUIRE_EQUAL( result.received.size(), 1u );
+      BOOST_CHECK_EQUAL( result.received.front().amount.value, 82 );
+      BOOST_CHECK_EQUAL( result.fees.size(), 6u );
+      trx.operations.clear();
+      verify_asset_supplies(db);
+
+      // Only the first and the last assets moved in the balances
+      BOOST_CHECK_EQUAL( db.get_balance( ted_id, aaa_id ).amount.value, 100 );
+      BOOST_CHECK_EQUAL( db.get_balance( ted_id, bbb_id ).amount.value, 0 );
+      BOOST_CHECK_EQUAL( db.get_balance( ted_id, ccc_id ).amount.value, 82 );
+      BOOST_CHECK_EQUAL( ab_id(db).balance_a.value, 1100 );
+      BOOST_CHECK_EQUAL( ab_id(db).balance_b.value, 910 );
+      BOOST_CHECK_EQUAL( bc_id(db).balance_a.value, 1090 );
+      BOOST_CHECK_EQUAL( bc_id(db).balance_b.value, 918 );
+      BOOST_CHECK_EQUAL( ac_id(db).balance_a.value, 100 );
+
+} catch (fc::exception& e) {
+   edump((e.to_detail_string()));
+   throw;
+} }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,10 +24,13 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <graphene/app/database_api.hpp>
 #include <graphene/chain/hardfork.hpp>
 
 #include <graphene/protocol/market.hpp>
+#include <graphene/chain/margin_call_index.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/order_book_index.hpp>
 
 #include "../common/database_fixture.hpp"
 
@@ -1890,4 +1893,267 @@ BOOST_AUTO_TEST_CASE(target_cr_test_call_limit_after_hf1270)
 } FC_LOG_AND_RETHROW() }
 
 
+
+/***
+ * The price levels of the order book follow the creation, the fills, the cancellation and the undo of orders
+ */
+BOOST_AUTO_TEST_CASE(order_book_index_test)
+{ try {
+   ACTORS((buyer)(seller));
+   const asset_object& usd = create_user_issued_asset( "MYUSD" );
+   const asset_id_type usd_id = usd.id;
+   issue_uia( seller, usd.amount(10000) );
+   transfer( committee_account, buyer_id, asset(10000) );
+
+   const auto& book = dynamic_cast<const base_primary_index&>( db.get_index_type<limit_order_index>() )
+                         .get_secondary_index<order_book_index>();
+
+   // Every level must hold the orders at its price, in the order of their creation
+   auto check_levels = [&]() {
+      size_t level_count = 0;
+      const auto& by_price = db.get_index_type<limit_order_index>().indices().get<by_price>();
+      for( auto itr = by_price.begin(); itr != by_price.end(); )
+      {
+         const price level_price = itr->sell_price;
+         const auto levels = book.get_levels( itr->sell_asset_id(), itr->receive_asset_id() );
+         auto level = levels.first;
+         while( level != levels.second && !( level->first == level_price ) )
+            ++level;
+         BOOST_REQUIRE( level != levels.second );
+         share_type for_sale;
+         auto order = level->second.orders.begin();
+         for( ; itr != by_price.end() && itr->sell_price == level_price; ++itr, ++order )
+         {
+            BOOST_REQUIRE( order != level->second.orders.end() );
+            BOOST_CHECK( *order == itr->id );
+            for_sale += itr->for_sale;
+         }
+         BOOST_CHECK( order == level->second.orders.end() );
+         BOOST_CHECK_EQUAL( level->second.for_sale.value, for_sale.value );
+         ++level_count;
+      }
+      BOOST_CHECK_EQUAL( book.get_level_count(), level_count );
+   };
+
+   // Three bids at the same price, and one at a worse price
+   create_sell_order( buyer_id, asset(100), asset(200, usd_id) );
+   create_sell_order( buyer_id, asset(100), asset(200, usd_id) );
+   const limit_order_id_type third_id = create_sell_order( buyer_id, asset(100), asset(200, usd_id) )->id;
+   create_sell_order( buyer_id, asset(100), asset(300, usd_id) );
+   check_levels();
+   auto bids = book.get_levels( asset_id_type(), usd_id );
+   BOOST_REQUIRE_EQUAL( std::distance( bids.first, bids.second ), 2 );
+   BOOST_CHECK_EQUAL( bids.first->second.for_sale.value, 300 );
+   BOOST_CHECK_EQUAL( bids.first->second.orders.size(), 3u );
+   BOOST_CHECK( !book.is_crossed_by( price( asset(300, usd_id), asset(200) ) ) );
+   BOOST_CHECK( book.is_crossed_by( price( asset(300, usd_id), asset(150) ) ) );
+
+   // An ask filling the first bid and half of the second one
+   BOOST_CHECK( create_sell_order( seller_id, asset(300, usd_id), asset(150) ) == nullptr );
+   check_levels();
+   bids = book.get_levels( asset_id_type(), usd_id );
+   BOOST_CHECK_EQUAL( bids.first->second.for_sale.value, 150 );
+   BOOST_CHECK_EQUAL( bids.first->second.orders.size(), 2u );
+   const auto asks = book.get_levels( usd_id, asset_id_type() );
+   BOOST_CHECK( asks.first == asks.second );
+
+   cancel_limit_order( third_id( db ) );
+   check_levels();
+   bids = book.get_levels( asset_id_type(), usd_id );
+   BOOST_CHECK_EQUAL( bids.first->second.for_sale.value, 50 );
+   BOOST_CHECK_EQUAL( bids.first->second.orders.size(), 1u );
+
+   // Undone orders are removed from their levels
+   {
+      auto session = db._undo_db.start_undo_session();
+      create_sell_order( buyer_id, asset(100), asset(400, usd_id) );
+      create_sell_order( seller_id, asset(500, usd_id), asset(1000) );
+      BOOST_CHECK_EQUAL( book.get_level_count(), 4u );
+      check_levels();
+   }
+   BOOST_CHECK_EQUAL( book.get_level_count(), 2u );
+   check_levels();
+
+   graphene::app::application_options opt = app.get_options();
+   graphene::app::database_api db_api( db, &opt );
+   const auto order_book = db_api.get_aggregated_order_book( GRAPHENE_SYMBOL, "MYUSD", 10 );
+   BOOST_REQUIRE_EQUAL( order_book.bids.size(), 2u );
+   BOOST_CHECK_EQUAL( order_book.bids[0].orders, 1u );
+   BOOST_CHECK_EQUAL( order_book.bids[1].orders, 1u );
+   BOOST_CHECK( order_book.asks.empty() );
+
+} FC_LOG_AND_RETHROW() }
+
+/***
+ * After the hard fork, a block cancels a bounded batch of the expired orders, earliest expiration first,
+ * and the following blocks cancel the rest
+ */
+BOOST_AUTO_TEST_CASE(expired_order_batch_test)
+{ try {
+   generate_blocks( HARDFORK_EXPIRED_ORDER_BATCH_TIME );
+   generate_block();
+   set_expiration( db, trx );
+
+   ACTORS((alice)(bob));
+   const asset_id_type usd_id = create_user_issued_asset( "MYUSD" ).id;
+   const uint32_t batch = GRAPHENE_MAX_EXPIRED_LIMIT_ORDERS_PER_BLOCK;
+   const uint32_t alice_count = batch + 10;
+   transfer( committee_account, alice_id, asset( int64_t( alice_count + 1 ) * 100 ) );
+   issue_uia( bob_id, asset( 500, usd_id ) );
+
+   const time_point_sec expiration = db.head_block_time() + fc::hours(1);
+   for( uint32_t i = 0; i < alice_count; ++i )
+      create_sell_order( alice_id, asset(100), asset( 200 + i, usd_id ), expiration );
+   for( uint32_t i = 0; i < 5; ++i )
+      create_sell_order( bob_id, asset( 100, usd_id ), asset( 1000 + i ), expiration );
+   create_sell_order( alice_id, asset(100), asset( 100000, usd_id ) );
+   generate_block();
+
+   const auto& limit_index = db.get_index_type<limit_order_index>().indices();
+   BOOST_CHECK_EQUAL( limit_index.size(), alice_count + 6 );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), 0 );
+   BOOST_CHECK_EQUAL( alice_id( db ).statistics( db ).total_core_in_orders.value, int64_t( alice_count + 1 ) * 100 );
+
+   // The first block after the expiration cancels the oldest orders of alice only
+   generate_blocks( expiration );
+   BOOST_CHECK_EQUAL( limit_index.size(), alice_count - batch + 6 );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), int64_t( batch ) * 100 );
+   BOOST_CHECK_EQUAL( alice_id( db ).statistics( db ).total_core_in_orders.value,
+                      int64_t( alice_count - batch + 1 ) * 100 );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, usd_id ), 0 );
+
+   // The next one cancels the rest, and leaves the order which does not expire
+   generate_block();
+   BOOST_CHECK_EQUAL( limit_index.size(), 1u );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), int64_t( alice_count ) * 100 );
+   BOOST_CHECK_EQUAL( alice_id( db ).statistics( db ).total_core_in_orders.value, 100 );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, usd_id ), 500 );
+
+} FC_LOG_AND_RETHROW() }
+
+/***
+ * The debt positions of an asset are kept least collateralized first, through borrowing, feed updates and undo
+ */
+BOOST_AUTO_TEST_CASE(margin_call_index_test)
+{ try {
+   auto mi = db.get_global_properties().parameters.maintenance_interval;
+   generate_blocks(HARDFORK_CORE_1270_TIME - mi);
+   generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+   generate_block();
+
+   set_expiration( db, trx );
+
+   ACTORS((borrower)(borrower2)(borrower3)(feedproducer));
+
+   const auto& bitusd = create_bitasset("USDBIT", feedproducer_id);
+   const asset_id_type usd_id = bitusd.id;
+   const auto& core   = asset_id_type()(db);
+
+   transfer(committee_account, borrower_id, asset(1000000));
+   transfer(committee_account, borrower2_id, asset(1000000));
+   transfer(committee_account, borrower3_id, asset(1000000));
+   update_feed_producers( bitusd, {feedproducer.id} );
+
+   price_feed current_feed;
+   current_feed.settlement_price = bitusd.amount( 100 ) / core.amount(100);
+   current_feed.maintenance_collateral_ratio = 1750;
+   current_feed.maximum_short_squeeze_ratio  = 1100;
+   publish_feed( bitusd, feedproducer, current_feed );
+
+   const auto& positions = dynamic_cast<const base_primary_index&>( db.get_index_type<call_order_index>() )
+                              .get_secondary_index<margin_call_index>();
+
+   // The positions must be those of the by_collateral index, in the same order
+   auto check_positions = [&]( const vector<call_order_id_type>& expected ) {
+      const auto& by_collateral = db.get_index_type<call_order_index>().indices().get<by_collateral>();
+      auto itr = by_collateral.lower_bound( price::min( asset_id_type(), usd_id ) );
+      const margin_call_index::position_set* set = positions.get_positions( usd_id );
+      BOOST_REQUIRE( set != nullptr );
+      BOOST_REQUIRE_EQUAL( set->size(), expected.size() );
+      auto position = set->begin();
+      for( const auto& id : expected )
+      {
+         BOOST_REQUIRE( itr != by_collateral.end() );
+         BOOST_CHECK( itr->id == id );
+         BOOST_CHECK( (*position)->id == id );
+         ++itr;
+         ++position;
+      }
+      BOOST_CHECK( positions.get_least_collateralized( usd_id ) == &expected.front()( db ) );
+   };
+
+   BOOST_CHECK( positions.get_least_collateralized( usd_id ) == nullptr );
+
+   const call_order_id_type b1_id = borrow( borrower, bitusd.amount(1000), asset(1800) )->id;
+   const call_order_id_type b2_id = borrow( borrower2, bitusd.amount(1000), asset(2000) )->id;
+   const call_order_id_type b3_id = borrow( borrower3, bitusd.amount(1000), asset(2500) )->id;
+   check_positions( { b1_id, b2_id, b3_id } );
+   BOOST_CHECK( !positions.has_callable_position( usd_id( db ).bitasset_data( db ) ) );
+
+   // Adding collateral moves the first position to the end
+   borrow( borrower, bitusd.amount(0), asset(1200) );
+   check_positions( { b2_id, b3_id, b1_id } );
+
+   // Withdrawn collateral and a higher maintenance collateral ratio make a position callable,
+   // there is nothing to call it with
+   {
+      auto session = db._undo_db.start_undo_session();
+      cover( borrower3, bitusd.amount(0), asset(600) );
+      check_positions( { b3_id, b2_id, b1_id } );
+      current_feed.maintenance_collateral_ratio = 2100;
+      publish_feed( bitusd, feedproducer, current_feed );
+      BOOST_CHECK( positions.has_callable_position( usd_id( db ).bitasset_data( db ) ) );
+   }
+   check_positions( { b2_id, b3_id, b1_id } );
+   BOOST_CHECK( !positions.has_callable_position( usd_id( db ).bitasset_data( db ) ) );
+
+   // Repaying a position removes it
+   cover( borrower2, bitusd.amount(1000), asset(2000) );
+   check_positions( { b3_id, b1_id } );
+
+} FC_LOG_AND_RETHROW() }
+
+/***
+ * After the hard fork, the expired orders left on the book by the bounded batches are cancelled when a taker
+ * crosses them, instead of being filled
+ */
+BOOST_AUTO_TEST_CASE(expired_order_backlog_not_matched_test)
+{ try {
+   generate_blocks( HARDFORK_EXPIRED_ORDER_BATCH_TIME );
+   generate_block();
+   set_expiration( db, trx );
+
+   ACTORS((alice)(bob));
+   const asset_id_type usd_id = create_user_issued_asset( "MYUSD" ).id;
+   const uint32_t batch = GRAPHENE_MAX_EXPIRED_LIMIT_ORDERS_PER_BLOCK;
+   const uint32_t alice_count = batch + 10;
+   transfer( committee_account, alice_id, asset( int64_t( alice_count ) * 100 ) );
+   issue_uia( bob_id, asset( 5000, usd_id ) );
+
+   const time_point_sec expiration = db.head_block_time() + fc::hours(1);
+   for( uint32_t i = 0; i < alice_count; ++i )
+      create_sell_order( alice_id, asset(100), asset( 200 + i, usd_id ), expiration );
+   generate_blocks( expiration );
+
+   // The first block after the expiration leaves the last orders of alice on the book
+   const auto& limit_index = db.get_index_type<limit_order_index>().indices();
+   BOOST_CHECK_EQUAL( limit_index.size(), alice_count - batch );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), int64_t( batch ) * 100 );
+
+   // bob would cross all of them, but they are cancelled instead of filled
+   set_expiration( db, trx );
+   const limit_order_object* bob_order = create_sell_order( bob_id, asset( 5000, usd_id ), asset( 100 ) );
+   BOOST_REQUIRE( bob_order != nullptr );
+   BOOST_CHECK_EQUAL( bob_order->for_sale.value, 5000 );
+   BOOST_CHECK_EQUAL( limit_index.size(), 1u );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), int64_t( alice_count ) * 100 );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, usd_id ), 0 );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 0 );
+
+   generate_block();
+   BOOST_CHECK_EQUAL( limit_index.size(), 1u );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 0 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
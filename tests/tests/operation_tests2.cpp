@@ -31,6 +31,7 @@
 #include <graphene/chain/budget_record_object.hpp>
 #include <graphene/chain/committee_member_object.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/top_holders_index.hpp>
 #include <graphene/chain/withdraw_permission_object.hpp>
 #include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/worker_object.hpp>
@@ -1750,7 +1751,9 @@ BOOST_AUTO_TEST_CASE(transfer_with_memo) {
       BOOST_CHECK_EQUAL(get_balance(alice_id, asset_id_type()), 500);
       BOOST_CHECK_EQUAL(get_balance(bob_id, asset_id_type()), 500);
 
-      auto memo = db.get_recent_transaction(trx.id()).operations.front().get<transfer_operation>().memo;
+      auto recent_trx = db.get_recent_transaction(trx.id());
+      BOOST_REQUIRE(recent_trx.valid());
+      auto memo = recent_trx->operations.front().get<transfer_operation>().memo;
       BOOST_CHECK(memo);
       BOOST_CHECK_EQUAL(memo->get_message(bob_private_key, alice_public_key), "Dear Bob,\n\nMoney!\n\nLove, Alice");
    } FC_LOG_AND_RETHROW()
@@ -2099,6 +2102,55 @@ BOOST_AUTO_TEST_CASE( top_n_special )
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( top_holders_index_test )
+{ try {
+   ACTORS( (alice)(bob)(chloe)(dan)(izzy)(stan) );
+   generate_blocks( HARDFORK_516_TIME );
+
+   const asset_id_type topn_id = create_user_issued_asset( "TOPN", izzy_id(db), 0 ).id;
+   const auto& holders_idx = dynamic_cast<const base_primary_index&>( db.get_index_type<account_balance_index>() )
+                                .get_secondary_index<top_holders_index>();
+   {
+      top_holders_special_authority top2;
+      top2.num_top_holders = 2;
+      top2.asset = topn_id;
+
+      account_update_operation op;
+      op.account = stan_id;
+      op.extensions.value.owner_special_authority = top2;
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      sign( trx, stan_private_key );
+      PUSH_TX( db, trx );
+      trx.clear();
+   }
+   set_expiration( db, trx );
+   issue_uia( alice_id, asset( 1000, topn_id ) );
+   issue_uia( bob_id, asset( 2000, topn_id ) );
+   issue_uia( chloe_id, asset( 3000, topn_id ) );
+   issue_uia( dan_id, asset( 4000, topn_id ) );
+
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   BOOST_CHECK( stan_id(db).owner == authority( 3501, chloe_id, 3000, dan_id, 4000 ) );
+   const uint64_t lookups = holders_idx.get_lookups();
+
+   // the listed holders follow the transfers
+   set_expiration( db, trx );
+   transfer( alice_id, bob_id, asset( 100, topn_id ) );
+   transfer( chloe_id, bob_id, asset( 50, topn_id ) );
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   BOOST_CHECK( stan_id(db).owner == authority( 3476, chloe_id, 2950, dan_id, 4000 ) );
+   BOOST_CHECK_EQUAL( holders_idx.get_lookups(), lookups );
+
+   // a listed holder falls behind a holder which is not listed, the holders are looked up again
+   set_expiration( db, trx );
+   transfer( dan_id, alice_id, asset( 3900, topn_id ) );
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   BOOST_CHECK( stan_id(db).owner == authority( 3876, alice_id, 4800, chloe_id, 2950 ) );
+   BOOST_CHECK_EQUAL( holders_idx.get_lookups(), lookups + 1 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( buyback )
 {
    ACTORS( (alice)(bob)(chloe)(dan)(izzy)(philbin) );
@@ -2235,4 +2287,59 @@ BOOST_AUTO_TEST_CASE( buyback )
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( buyback_without_asset_to_buy )
+{ try {
+   ACTORS( (alice)(izzy)(philbin) );
+   upgrade_to_lifetime_member(philbin_id);
+
+   generate_blocks( HARDFORK_555_TIME );
+
+   asset_id_type buyme_id = create_user_issued_asset( "BUYME", izzy_id(db), 0 ).id;
+   asset_id_type sellme_id = create_user_issued_asset( "SELLME", izzy_id(db), 0 ).id;
+
+   // A buyback account selling CORE and SELLME, which does not hold BUYME yet
+   account_id_type rex_id;
+   {
+      buyback_account_options bbo;
+      bbo.asset_to_buy = buyme_id;
+      bbo.asset_to_buy_issuer = izzy_id;
+      bbo.markets.emplace( asset_id_type() );
+      bbo.markets.emplace( sellme_id );
+      account_create_operation create_op = make_account( "rex" );
+      create_op.registrar = philbin_id;
+      create_op.extensions.value.buyback_options = bbo;
+      create_op.owner = authority::null_authority();
+      create_op.active = authority::null_authority();
+
+      signed_transaction tx;
+      tx.operations.push_back( create_op );
+      set_expiration( db, tx );
+      sign( tx, izzy_private_key );
+      sign( tx, philbin_private_key );
+      processed_transaction ptx = PUSH_TX( db, tx );
+      rex_id = ptx.operation_results.back().get< object_id_type >();
+   }
+
+   set_expiration( db, trx );
+   issue_uia( alice_id, asset( 1000, buyme_id ) );
+   issue_uia( rex_id, asset( 100, sellme_id ) );
+   fund( rex_id(db), asset( 100, asset_id_type() ) );
+   limit_order_id_type core_order_id = create_sell_order( alice_id, asset( 10, buyme_id ),
+                                                          asset( 100, asset_id_type() ) )->id;
+   limit_order_id_type sellme_order_id = create_sell_order( alice_id, asset( 10, buyme_id ),
+                                                            asset( 100, sellme_id ) )->id;
+   BOOST_CHECK_EQUAL( get_balance( rex_id, buyme_id ), 0 );
+
+   // Selling CORE creates the BUYME balance of rex, and SELLME is still sold after it
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   generate_block();
+
+   BOOST_CHECK( db.find( core_order_id ) == nullptr );
+   BOOST_CHECK( db.find( sellme_order_id ) == nullptr );
+   BOOST_CHECK_EQUAL( get_balance( rex_id, asset_id_type() ), 0 );
+   BOOST_CHECK_EQUAL( get_balance( rex_id, sellme_id ), 0 );
+   BOOST_CHECK_EQUAL( get_balance( rex_id, buyme_id ), 20 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
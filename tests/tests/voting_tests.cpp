@@ -453,6 +453,114 @@ BOOST_AUTO_TEST_CASE(invalid_voting_account)
 
    } FC_LOG_AND_RETHROW()
 }
+BOOST_AUTO_TEST_CASE(tally_votes_after_snapshot_hardfork)
+{
+   try
+   {
+      generate_blocks(HARDFORK_VOTE_TALLY_SNAPSHOT_TIME);
+      set_expiration(db, trx);
+
+      ACTORS((alice)(bob)(wit));
+
+      upgrade_to_lifetime_member(wit_id);
+      const witness_id_type wit_witness_id = create_witness(wit_id, wit_private_key).id;
+
+      transfer(committee_account, alice_id, asset(100));
+      transfer(committee_account, bob_id, asset(50));
+
+      // alice votes for the witness, and bob lets alice vote with his stake
+      graphene::chain::account_update_operation op;
+      op.account = alice_id;
+      op.new_options = alice_id(db).options;
+      op.new_options->votes.insert(wit_witness_id(db).vote_id);
+      trx.operations.push_back(op);
+
+      op.account = bob_id;
+      op.new_options = bob_id(db).options;
+      op.new_options->voting_account = alice_id;
+      trx.operations.push_back(op);
+
+      sign(trx, alice_private_key);
+      sign(trx, bob_private_key);
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+
+      BOOST_CHECK_EQUAL(wit_witness_id(db).total_votes, 150u);
+
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(running_vote_tally_follows_changes)
+{
+   try
+   {
+      generate_blocks(HARDFORK_VOTE_TALLY_SNAPSHOT_TIME);
+      set_expiration(db, trx);
+
+      ACTORS((alice)(bob)(wit));
+
+      upgrade_to_lifetime_member(wit_id);
+      const witness_id_type wit_witness_id = create_witness(wit_id, wit_private_key).id;
+
+      transfer(committee_account, alice_id, asset(100));
+      transfer(committee_account, bob_id, asset(50));
+
+      graphene::chain::account_update_operation op;
+      op.account = alice_id;
+      op.new_options = alice_id(db).options;
+      op.new_options->votes.insert(wit_witness_id(db).vote_id);
+      trx.operations.push_back(op);
+      sign(trx, alice_private_key);
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+
+      // The tally is built from scratch at this maintenance, as a vote id was added since the previous one
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      BOOST_CHECK_EQUAL(wit_witness_id(db).total_votes, 100u);
+
+      // bob lets alice vote with his stake, and alice moves part of her stake away
+      op.account = bob_id;
+      op.new_options = bob_id(db).options;
+      op.new_options->voting_account = alice_id;
+      trx.operations.push_back(op);
+      sign(trx, bob_private_key);
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+      transfer(alice_id, committee_account, asset(30));
+
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      BOOST_CHECK_EQUAL(wit_witness_id(db).total_votes, 120u);
+
+      // alice withdraws her vote, which takes bob's stake with it
+      op.account = alice_id;
+      op.new_options = alice_id(db).options;
+      op.new_options->votes.clear();
+      trx.operations.push_back(op);
+      sign(trx, alice_private_key);
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      BOOST_CHECK_EQUAL(wit_witness_id(db).total_votes, 0u);
+
+      // bob votes on his own again
+      op.account = bob_id;
+      op.new_options = bob_id(db).options;
+      op.new_options->voting_account = GRAPHENE_PROXY_TO_SELF_ACCOUNT;
+      op.new_options->votes.insert(wit_witness_id(db).vote_id);
+      trx.operations.push_back(op);
+      sign(trx, bob_private_key);
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      BOOST_CHECK_EQUAL(wit_witness_id(db).total_votes, 50u);
+
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE(last_voting_date)
 {
    try